@@ -0,0 +1,92 @@
+#ifndef ADMISSION_CONTROL_H
+#define ADMISSION_CONTROL_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <sys/socket.h>
+
+// Bounds the connections a server holds and the work queued behind them. A connection
+// over either hard limit is answered with a canned 503 and closed at accept time, before
+// it costs a worker or a parse. Past the shed threshold requests are admitted by priority:
+// the caller's priority class keeps being served while everything else gets 503 +
+// Retry-After, so the server degrades instead of timing out across the board.
+class AdmissionControl {
+public:
+    struct Limits {
+        int maxConnections = 0;  // admitted connections, queued ones included; 0 = unlimited
+        size_t maxQueued = 0;    // connections waiting for a worker; 0 = unlimited
+        int shedPercent = 80;    // load (% of either limit) above which only priority requests run
+        int retryAfter = 1;      // seconds, sent in Retry-After
+    };
+
+    void setLimits(const Limits& newLimits) {
+        limits = newLimits;
+        retryAfterLine = "Retry-After: " + std::to_string(limits.retryAfter) + "\r\n";
+        std::string body = "{\"status\":\"error\",\"message\":\"Server overloaded, retry later\"}";
+        overloadResponse = "HTTP/1.1 503 Service Unavailable\r\n"
+                           "Content-Type: application/json\r\n"
+                           "Content-Length: " + std::to_string(body.size()) + "\r\n" +
+                           retryAfterLine + "Connection: close\r\n\r\n" + body;
+    }
+
+    const Limits& getLimits() const { return limits; }
+
+    // Claim a slot for a newly accepted connection; false when a hard limit is reached.
+    // Every true must be paired with exactly one releaseConnection().
+    bool tryAdmitConnection(size_t queued) {
+        if (limits.maxQueued > 0 && queued >= limits.maxQueued) {
+            rejected.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        int current = inFlight.load(std::memory_order_relaxed);
+        do {
+            if (limits.maxConnections > 0 && current >= limits.maxConnections) {
+                rejected.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+        } while (!inFlight.compare_exchange_weak(current, current + 1, std::memory_order_relaxed));
+        return true;
+    }
+
+    void releaseConnection() { inFlight.fetch_sub(1, std::memory_order_relaxed); }
+
+    // Best effort 503 on a connection that was not admitted; the caller closes it
+    void rejectConnection(int socket) const {
+        send(socket, overloadResponse.data(), overloadResponse.size(), MSG_DONTWAIT | MSG_NOSIGNAL);
+    }
+
+    // Whether a request should be served at the current load
+    bool admitRequest(bool priority, size_t queued) {
+        if (priority || !overloaded(queued)) return true;
+        shed.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    bool overloaded(size_t queued) const {
+        int connections = inFlight.load(std::memory_order_relaxed);
+        if (limits.maxConnections > 0 && connections * 100LL >= (long long)limits.maxConnections * limits.shedPercent) {
+            return true;
+        }
+        return limits.maxQueued > 0 && queued * 100 >= limits.maxQueued * limits.shedPercent;
+    }
+
+    int connections() const { return inFlight.load(std::memory_order_relaxed); }
+    uint64_t rejectedConnections() const { return rejected.load(std::memory_order_relaxed); }
+    uint64_t shedRequests() const { return shed.load(std::memory_order_relaxed); }
+
+    // "Retry-After: N\r\n" for 503 responses built by the caller
+    std::string_view retryAfterHeader() const { return retryAfterLine; }
+
+private:
+    Limits limits;
+    std::string retryAfterLine = "Retry-After: 1\r\n";
+    std::string overloadResponse;
+    std::atomic<int> inFlight{0};
+    std::atomic<uint64_t> rejected{0};
+    std::atomic<uint64_t> shed{0};
+};
+
+#endif // ADMISSION_CONTROL_H
@@ -0,0 +1,91 @@
+#ifndef ALLOC_STATS_H
+#define ALLOC_STATS_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <string>
+
+// Heap allocation counting for profiling builds (make alloc-stats). With
+// TALLY_ALLOC_STATS defined this header replaces the global operator new, so it
+// must be included by exactly one translation unit; otherwise it compiles to no-ops.
+class AllocStats {
+public:
+#ifdef TALLY_ALLOC_STATS
+    static constexpr bool enabled = true;
+#else
+    static constexpr bool enabled = false;
+#endif
+
+    // Allocations made so far by the calling thread
+    static uint64_t threadCount() { return counter(); }
+
+    // Adds the allocations made on this thread while it is alive to the request totals
+    class Scope {
+    public:
+        Scope() : start(threadCount()) {}
+        ~Scope() {
+            if (!enabled) return;
+            totals().allocations.fetch_add(threadCount() - start, std::memory_order_relaxed);
+            totals().requests.fetch_add(1, std::memory_order_relaxed);
+        }
+
+    private:
+        uint64_t start;
+    };
+
+    static std::string toJson() {
+        if (!enabled) return "{\"enabled\":false}";
+        uint64_t requests = totals().requests.load(std::memory_order_relaxed);
+        uint64_t allocations = totals().allocations.load(std::memory_order_relaxed);
+        return "{\"enabled\":true,\"requests\":" + std::to_string(requests) +
+               ",\"allocations\":" + std::to_string(allocations) +
+               ",\"per_request\":" + std::to_string(requests ? (double)allocations / requests : 0.0) + "}";
+    }
+
+    static uint64_t& counter() {
+        static thread_local uint64_t count = 0;
+        return count;
+    }
+
+private:
+    struct Totals {
+        std::atomic<uint64_t> requests{0};
+        std::atomic<uint64_t> allocations{0};
+    };
+
+    static Totals& totals() {
+        static Totals instance;
+        return instance;
+    }
+};
+
+#ifdef TALLY_ALLOC_STATS
+// Every allocating form is replaced alongside its matching deallocation, so scalar,
+// array, sized and over-aligned new/delete pairs all go through the same heap
+inline void* allocStatsAllocate(std::size_t size, std::size_t alignment = 0) {
+    AllocStats::counter()++;
+    if (size == 0) size = 1;
+    void* p = alignment ? std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment)
+                        : std::malloc(size);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void* operator new(std::size_t size) { return allocStatsAllocate(size); }
+void* operator new[](std::size_t size) { return allocStatsAllocate(size); }
+void* operator new(std::size_t size, std::align_val_t al) { return allocStatsAllocate(size, (std::size_t)al); }
+void* operator new[](std::size_t size, std::align_val_t al) { return allocStatsAllocate(size, (std::size_t)al); }
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+#endif
+
+#endif // ALLOC_STATS_H
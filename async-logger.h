@@ -0,0 +1,306 @@
+#ifndef ASYNC_LOGGER_H
+#define ASYNC_LOGGER_H
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <memory>
+#include <mutex>
+#include <signal.h>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+
+enum class LogLevel { Debug, Info, Warn, Error };
+
+// Log file writer that never blocks the thread logging. Each line is formatted straight
+// into a slot of a bounded lock-free MPSC ring; one background thread drains the ring
+// and hands whole batches to write(2). When the ring is full the line is dropped and
+// counted rather than making a request thread wait for the disk.
+class AsyncLogger {
+public:
+    static constexpr size_t LINE_BYTES = 256; // longer lines are truncated
+
+    explicit AsyncLogger(size_t capacity = 4096) : fd(-1), minLevel(LogLevel::Info), running(false),
+                                                   enqueuePos(0), dequeuePos(0), written(0), dropped(0) {
+        size_t slotCount = 1;
+        while (slotCount < capacity) slotCount *= 2;
+        slots.reset(new Slot[slotCount]);
+        mask = slotCount - 1;
+        for (size_t i = 0; i < slotCount; i++) slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    ~AsyncLogger() { close(); }
+
+    AsyncLogger(const AsyncLogger&) = delete;
+    AsyncLogger& operator=(const AsyncLogger&) = delete;
+
+    // `lineTag` is written after the level on every line, e.g. the user the server runs as
+    bool open(const std::string& path, LogLevel level = LogLevel::Info, const std::string& lineTag = "") {
+        close();
+        fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+        if (fd < 0) return false;
+        minLevel = level;
+        tag = lineTag.empty() ? "" : "[" + lineTag + "] ";
+        running = true;
+        flusher = std::thread(&AsyncLogger::flushLoop, this);
+        registerOpen(this, true);
+        return true;
+    }
+
+    // Write out everything queued, then stop the flusher
+    void close() {
+        if (!running) return;
+        registerOpen(this, false);
+        {
+            std::lock_guard<std::mutex> lock(wakeMutex);
+            running = false;
+        }
+        wake.notify_one();
+        if (flusher.joinable()) flusher.join();
+        ::close(fd);
+        fd = -1;
+    }
+
+    bool isOpen() const { return running; }
+    bool enabled(LogLevel level) const { return running && level >= minLevel; }
+
+    void log(LogLevel level, std::string_view message) {
+        if (!enabled(level)) return;
+        Line line = begin();
+        if (!line) return;
+        line.append(timestamp()).append(" ").append(levelName(level)).append(" ").append(tag).append(message);
+        commit(line);
+    }
+
+    void debug(std::string_view message) { log(LogLevel::Debug, message); }
+    void info(std::string_view message) { log(LogLevel::Info, message); }
+    void warn(std::string_view message) { log(LogLevel::Warn, message); }
+    void error(std::string_view message) { log(LogLevel::Error, message); }
+
+    // One access-log line: client, request line, status, bytes queued and handler latency
+    void access(std::string_view client, std::string_view method, std::string_view target,
+                std::string_view version, int status, size_t bytes, uint64_t micros) {
+        if (!running) return;
+        Line line = begin();
+        if (!line) return;
+        line.append(client).append(" - [").append(timestamp()).append("] \"").append(method).append(" ")
+            .append(target).append(" ").append(version).append("\" ").number(status).append(" ")
+            .number(bytes).append(" ").number(micros).append("us");
+        commit(line);
+    }
+
+    uint64_t linesWritten() const { return written.load(std::memory_order_relaxed); }
+    uint64_t linesDropped() const { return dropped.load(std::memory_order_relaxed); }
+
+    static bool parseLevel(std::string_view name, LogLevel& level) {
+        if (name == "debug") level = LogLevel::Debug;
+        else if (name == "info") level = LogLevel::Info;
+        else if (name == "warn") level = LogLevel::Warn;
+        else if (name == "error") level = LogLevel::Error;
+        else return false;
+        return true;
+    }
+
+private:
+    struct Slot {
+        std::atomic<size_t> sequence;
+        uint32_t length = 0;
+        char text[LINE_BYTES];
+    };
+
+    // A claimed slot being filled by one producer; reserves room for the newline
+    class Line {
+    public:
+        Line(Slot* slot, size_t position) : slot(slot), position(position), length(0) {}
+        explicit operator bool() const { return slot != nullptr; }
+
+        Line& append(std::string_view text) {
+            size_t room = LINE_BYTES - 1 - length;
+            size_t n = std::min(room, text.size());
+            memcpy(slot->text + length, text.data(), n);
+            length += n;
+            return *this;
+        }
+
+        Line& number(uint64_t value) {
+            char digits[24];
+            size_t n = 0;
+            do {
+                digits[sizeof(digits) - 1 - n++] = char('0' + value % 10);
+                value /= 10;
+            } while (value);
+            return append(std::string_view(digits + sizeof(digits) - n, n));
+        }
+
+    private:
+        friend class AsyncLogger;
+        Slot* slot;
+        size_t position;
+        size_t length;
+    };
+
+    static constexpr size_t BATCH_BYTES = 64 * 1024;
+    static constexpr auto FLUSH_INTERVAL = std::chrono::milliseconds(50);
+
+    int fd;
+    LogLevel minLevel;
+    std::string tag;
+    std::atomic<bool> running;
+    std::unique_ptr<Slot[]> slots;
+    size_t mask;
+    alignas(64) std::atomic<size_t> enqueuePos;
+    alignas(64) size_t dequeuePos; // flusher thread only
+    std::atomic<uint64_t> written;
+    std::atomic<uint64_t> dropped;
+    std::thread flusher;
+    std::mutex wakeMutex;
+    std::condition_variable wake;
+
+    static const char* levelName(LogLevel level) {
+        switch (level) {
+            case LogLevel::Debug: return "DEBUG";
+            case LogLevel::Info: return "INFO ";
+            case LogLevel::Warn: return "WARN ";
+            default: return "ERROR";
+        }
+    }
+
+    // Local time to the second, reformatted only when the second changes
+    static std::string_view timestamp() {
+        thread_local time_t cachedSecond = -1;
+        thread_local char text[32];
+        thread_local size_t length = 0;
+        time_t now = time(nullptr);
+        if (now != cachedSecond) {
+            struct tm parts;
+            localtime_r(&now, &parts);
+            length = strftime(text, sizeof(text), "%Y-%m-%d %H:%M:%S", &parts);
+            cachedSecond = now;
+        }
+        return std::string_view(text, length);
+    }
+
+    // Claim the next free slot (Vyukov bounded queue); an empty Line when the ring is full
+    Line begin() {
+        size_t position = enqueuePos.load(std::memory_order_relaxed);
+        while (true) {
+            Slot& slot = slots[position & mask];
+            size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            intptr_t difference = (intptr_t)sequence - (intptr_t)position;
+            if (difference == 0) {
+                if (enqueuePos.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    return Line(&slot, position);
+                }
+            } else if (difference < 0) {
+                dropped.fetch_add(1, std::memory_order_relaxed);
+                return Line(nullptr, 0);
+            } else {
+                position = enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    void commit(Line& line) {
+        line.slot->text[line.length++] = '\n';
+        line.slot->length = (uint32_t)line.length;
+        line.slot->sequence.store(line.position + 1, std::memory_order_release);
+    }
+
+    // Loggers still open when the process calls exit() (the signal handlers do) are
+    // closed from an atexit hook, so lines queued just before shutdown still reach disk
+    static void registerOpen(AsyncLogger* logger, bool add) {
+        std::lock_guard<std::mutex> lock(openMutex());
+        std::vector<AsyncLogger*>& loggers = openLoggers();
+        // Registered after the registry exists, so the hook runs before it is destroyed
+        static bool hooked = std::atexit(closeAllAtExit) == 0;
+        (void)hooked;
+        if (add) {
+            loggers.push_back(logger);
+        } else {
+            loggers.erase(std::remove(loggers.begin(), loggers.end(), logger), loggers.end());
+        }
+    }
+
+    static void closeAllAtExit() {
+        std::vector<AsyncLogger*> loggers;
+        {
+            std::lock_guard<std::mutex> lock(openMutex());
+            loggers = openLoggers();
+        }
+        for (AsyncLogger* logger : loggers) logger->close();
+    }
+
+    static std::mutex& openMutex() {
+        static std::mutex mutex;
+        return mutex;
+    }
+
+    static std::vector<AsyncLogger*>& openLoggers() {
+        static std::vector<AsyncLogger*> loggers;
+        return loggers;
+    }
+
+    // Copy committed lines into `batch`; false once the ring is empty
+    bool drain(std::string& batch) {
+        while (batch.size() + LINE_BYTES <= BATCH_BYTES) {
+            Slot& slot = slots[dequeuePos & mask];
+            if (slot.sequence.load(std::memory_order_acquire) != dequeuePos + 1) return false;
+            batch.append(slot.text, slot.length);
+            slot.sequence.store(dequeuePos + mask + 1, std::memory_order_release);
+            dequeuePos++;
+            written.fetch_add(1, std::memory_order_relaxed);
+        }
+        return true;
+    }
+
+    void writeBatch(const std::string& batch) {
+        size_t offset = 0;
+        while (offset < batch.size()) {
+            ssize_t n = ::write(fd, batch.data() + offset, batch.size() - offset);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) return; // disk full or similar: lose this batch, keep serving
+            offset += n;
+        }
+    }
+
+    void flushLoop() {
+        // Signals go to the request threads; a handler calling exit() here could never join us
+        sigset_t all;
+        sigfillset(&all);
+        pthread_sigmask(SIG_BLOCK, &all, nullptr);
+
+        std::string batch;
+        batch.reserve(BATCH_BYTES);
+        while (true) {
+            bool more = drain(batch);
+            if (!batch.empty()) {
+                writeBatch(batch);
+                batch.clear();
+            }
+            if (more) continue;
+
+            std::unique_lock<std::mutex> lock(wakeMutex);
+            if (!running) break;
+            wake.wait_for(lock, FLUSH_INTERVAL);
+        }
+        // Lines committed after the last drain but before close()
+        while (true) {
+            bool more = drain(batch);
+            writeBatch(batch);
+            batch.clear();
+            if (!more) break;
+        }
+    }
+};
+
+#endif // ASYNC_LOGGER_H
@@ -0,0 +1,40 @@
+#!/bin/bash
+# Heap allocations per request for a standard request mix against an allocation-counting
+# build. Usage: bench/alloc-mix.sh [server-binary] [port]   (run via: make alloc-stats)
+SERVER=${1:-./tally-server-allocs}
+PORT=${2:-18080}
+ROUNDS=${ROUNDS:-50}
+
+"$SERVER" --daemon --port "$PORT" > /dev/null 2>&1 &
+PID=$!
+trap 'kill $PID 2>/dev/null' EXIT
+for _ in $(seq 50); do
+    curl -s -o /dev/null "http://localhost:$PORT/api/tally/status" && break
+    sleep 0.1
+done
+
+# One request of each kind per round: API reads, an API write, an HTML page,
+# a cached static asset (identity and gzip) and a 404
+MIX=(/api/tally/status /api/server/info /api/network/peers /api/network/status
+     /api/tally/combine /index.html /icon.svg /missing.txt)
+URLS=()
+for _ in $(seq "$ROUNDS"); do
+    for path in "${MIX[@]}"; do URLS+=("http://localhost:$PORT$path"); done
+done
+
+stats() {
+    curl -s "http://localhost:$PORT/api/server/stats" | sed -n 's/.*"allocations":\({[^}]*}\).*/\1/p'
+}
+
+# Warm the caches and per-connection buffers first, then measure
+curl -s "${URLS[@]:0:${#MIX[@]}}" > /dev/null
+BEFORE=$(stats)
+curl -s "${URLS[@]}" > /dev/null
+curl -s --compressed "${URLS[@]}" > /dev/null
+AFTER=$(stats)
+
+field() { echo "$1" | sed -n "s/.*\"$2\":\([0-9.]*\).*/\1/p"; }
+REQUESTS=$(( $(field "$AFTER" requests) - $(field "$BEFORE" requests) - 1 ))
+ALLOCATIONS=$(( $(field "$AFTER" allocations) - $(field "$BEFORE" allocations) ))
+echo "📊 ${REQUESTS} requests (${#MIX[@]} kinds x ${ROUNDS} rounds x identity+gzip)"
+echo "🧮 ${ALLOCATIONS} heap allocations, $(awk "BEGIN { printf \"%.2f\", $ALLOCATIONS / $REQUESTS }") per request"
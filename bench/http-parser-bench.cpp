@@ -0,0 +1,148 @@
+// Parse-throughput microbenchmark for http-parser.h
+// Build and run with: make parser-bench
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "../http-parser.h"
+
+struct BenchCase {
+    std::string name;
+    std::string bytes;       // one or more back-to-back requests
+    int requestsPerPass;
+    size_t segmentSize;      // 0 = whole buffer at once, otherwise feed in slices of this size
+};
+
+static volatile size_t sink;
+
+// Parse every request in `bytes`, feeding the parser the way a socket would
+static int parseAll(HttpParser& parser, const std::string& bytes, size_t segmentSize) {
+    std::string_view all(bytes);
+    size_t start = 0;
+    size_t available = segmentSize ? std::min(segmentSize, all.size()) : all.size();
+    int parsed = 0;
+
+    while (start < all.size()) {
+        HttpParser::Status status = parser.parse(all.substr(start, available - start));
+        if (status == HttpParser::Status::Complete) {
+            sink += parser.request().headers.size() + parser.request().body.size();
+            start += parser.consumed();
+            parser.reset();
+            parsed++;
+            if (available < start) available = start;
+            continue;
+        }
+        if (status == HttpParser::Status::Error) {
+            std::cerr << "❌ Parse error " << parser.errorCode() << std::endl;
+            std::exit(1);
+        }
+        if (available == all.size()) break;
+        available = segmentSize ? std::min(available + segmentSize, all.size()) : all.size();
+    }
+    return parsed;
+}
+
+// The tokenizer handleClient used before http-parser.h, kept for comparison
+static int parseLegacy(const std::string& bytes) {
+    std::string request(bytes);
+    std::string method, path, httpVersion;
+    std::istringstream requestStream(request);
+    requestStream >> method >> path >> httpVersion;
+    sink += method.size() + path.size();
+    return 1;
+}
+
+int main(int argc, char* argv[]) {
+    double seconds = 0.5;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if ((arg == "--seconds" || arg == "-s") && i + 1 < argc) {
+            seconds = std::atof(argv[++i]);
+        }
+    }
+
+    std::string simpleGet = "GET /api/tally/status HTTP/1.1\r\nHost: localhost:8080\r\n\r\n";
+    std::string browserGet =
+        "GET /tally.html?view=full HTTP/1.1\r\n"
+        "Host: localhost:8080\r\n"
+        "User-Agent: Mozilla/5.0 (X11; Linux x86_64; rv:128.0) Gecko/20100101 Firefox/128.0\r\n"
+        "Accept: text/html,application/xhtml+xml,application/xml;q=0.9,*/*;q=0.8\r\n"
+        "Accept-Language: en-US,en;q=0.5\r\n"
+        "Accept-Encoding: gzip, deflate, br\r\n"
+        "Connection: keep-alive\r\n"
+        "Upgrade-Insecure-Requests: 1\r\n"
+        "Sec-Fetch-Dest: document\r\n"
+        "Sec-Fetch-Mode: navigate\r\n"
+        "Sec-Fetch-Site: none\r\n"
+        "Cache-Control: max-age=0\r\n"
+        "\r\n";
+    std::string json = "{\"filename\":\"notes/ledger.txt\",\"content\":\"" + std::string(512, 'x') + "\"}";
+    std::string post =
+        "POST /api/save HTTP/1.1\r\nHost: localhost:8000\r\nContent-Type: application/json\r\n"
+        "Content-Length: " + std::to_string(json.size()) + "\r\n\r\n" + json;
+    std::string chunked =
+        "POST /api/save HTTP/1.1\r\nHost: localhost:8000\r\nTransfer-Encoding: chunked\r\n\r\n"
+        "100\r\n" + std::string(256, 'a') + "\r\n"
+        "100\r\n" + std::string(256, 'b') + "\r\n"
+        "0\r\n\r\n";
+    std::string pipelined;
+    for (int i = 0; i < 16; i++) pipelined += simpleGet;
+
+    std::vector<BenchCase> cases = {
+        {"simple GET", simpleGet, 1, 0},
+        {"browser GET (11 headers)", browserGet, 1, 0},
+        {"POST Content-Length 540B", post, 1, 0},
+        {"POST chunked 512B", chunked, 1, 0},
+        {"16 pipelined GETs", pipelined, 16, 0},
+        {"browser GET in 64B segments", browserGet, 1, 64},
+    };
+
+    std::cout << "⚡ HTTP parser throughput (" << seconds << "s per case)" << std::endl;
+    std::cout << std::left << std::setw(32) << "case" << std::right << std::setw(14) << "req/s"
+              << std::setw(12) << "MB/s" << std::endl;
+
+    HttpParser parser;
+    for (const auto& bench : cases) {
+        // Warm up caches and the parser's reusable vectors
+        for (int i = 0; i < 1000; i++) parseAll(parser, bench.bytes, bench.segmentSize);
+
+        long long requests = 0, passes = 0;
+        auto start = std::chrono::steady_clock::now();
+        auto deadline = start + std::chrono::duration<double>(seconds);
+        while (std::chrono::steady_clock::now() < deadline) {
+            for (int i = 0; i < 256; i++) {
+                requests += parseAll(parser, bench.bytes, bench.segmentSize);
+            }
+            passes += 256;
+        }
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        if (requests != passes * bench.requestsPerPass) {
+            std::cerr << "❌ " << bench.name << ": parsed " << requests << " requests, expected "
+                      << passes * bench.requestsPerPass << std::endl;
+            return 1;
+        }
+
+        std::cout << std::left << std::setw(32) << bench.name << std::right << std::fixed
+                  << std::setprecision(0) << std::setw(14) << requests / elapsed << std::setprecision(1)
+                  << std::setw(12) << (passes * bench.bytes.size()) / elapsed / 1e6 << std::endl;
+    }
+
+    // Baseline: request-line tokenizing with std::istringstream
+    long long legacy = 0;
+    auto start = std::chrono::steady_clock::now();
+    auto deadline = start + std::chrono::duration<double>(seconds);
+    while (std::chrono::steady_clock::now() < deadline) {
+        for (int i = 0; i < 256; i++) legacy += parseLegacy(browserGet);
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << std::left << std::setw(32) << "legacy istringstream (browser)" << std::right << std::fixed
+              << std::setprecision(0) << std::setw(14) << legacy / elapsed << std::setprecision(1)
+              << std::setw(12) << (legacy * browserGet.size()) / elapsed / 1e6 << std::endl;
+
+    return 0;
+}
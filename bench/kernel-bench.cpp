@@ -0,0 +1,243 @@
+// Microbenchmarks for the ledger, hashing and cipher kernels, swept over input sizes
+// from 64 B to 16 MB. Build and run with: make kernel-bench
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sched.h>
+#include <string>
+#include <vector>
+#include "../caesar-cipher.h"
+#include "../page-fingerprint.h"
+#include "../peer-network.h"
+#include "../tally-asm.h"
+#include "../tally-ledger.h"
+
+static volatile size_t sink;
+
+// One kernel at one input size. `run` performs a single operation; `reset`, when set,
+// restores state between repetitions outside the timed region.
+struct BenchCase {
+    std::string kernel;
+    size_t bytes; // 0 for kernels without a size parameter
+    std::function<void()> run;
+    std::function<void()> reset;
+};
+
+struct BenchResult {
+    std::string kernel;
+    size_t bytes;
+    uint64_t iterations; // per repetition
+    double minNs, medianNs, meanNs, stddevNs;
+};
+
+struct BenchOptions {
+    int cpu = 0;               // -1 leaves scheduling to the OS
+    int repetitions = 5;
+    double minSeconds = 0.05;  // shortest timed repetition
+    double warmupSeconds = 0.1;
+    size_t maxBytes = 16 * 1024 * 1024;
+    std::string filter;
+    std::string jsonFile;
+};
+
+static double elapsedNs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+}
+
+static double timeBatch(const BenchCase& bench, uint64_t iterations) {
+    if (bench.reset) bench.reset();
+    auto start = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < iterations; i++) bench.run();
+    return elapsedNs(start);
+}
+
+static BenchResult measure(const BenchCase& bench, const BenchOptions& options) {
+    // Warm caches, branch predictors and CPU frequency, then size the batch so one
+    // repetition lasts at least minSeconds
+    uint64_t iterations = 1;
+    double warmed = 0;
+    while (warmed < options.warmupSeconds * 1e9) {
+        double ns = timeBatch(bench, iterations);
+        warmed += ns;
+        if (ns < options.minSeconds * 1e9) iterations *= 2;
+    }
+    while (timeBatch(bench, iterations) < options.minSeconds * 1e9) iterations *= 2;
+
+    std::vector<double> perOp;
+    for (int r = 0; r < options.repetitions; r++) perOp.push_back(timeBatch(bench, iterations) / iterations);
+    std::sort(perOp.begin(), perOp.end());
+
+    BenchResult result{bench.kernel, bench.bytes, iterations, perOp.front(), 0, 0, 0};
+    size_t middle = perOp.size() / 2;
+    result.medianNs = perOp.size() % 2 ? perOp[middle] : (perOp[middle - 1] + perOp[middle]) / 2;
+    for (double ns : perOp) result.meanNs += ns / perOp.size();
+    for (double ns : perOp) result.stddevNs += (ns - result.meanNs) * (ns - result.meanNs);
+    result.stddevNs = perOp.size() > 1 ? std::sqrt(result.stddevNs / (perOp.size() - 1)) : 0;
+    return result;
+}
+
+static std::string text(size_t bytes) {
+    static const std::string sample = "The King's Reckoning 1701: user, network and collective tallies. ";
+    std::string out;
+    out.reserve(bytes);
+    while (out.size() < bytes) out.append(sample, 0, std::min(sample.size(), bytes - out.size()));
+    return out;
+}
+
+static std::string html(size_t bytes) {
+    std::string page = "<html><head><title>tally</title></head><body class=\"main\">";
+    return page + text(bytes > page.size() ? bytes - page.size() : 0);
+}
+
+static std::string sizeLabel(size_t bytes) {
+    if (bytes == 0) return "-";
+    if (bytes >= 1024 * 1024) return std::to_string(bytes / (1024 * 1024)) + " MB";
+    if (bytes >= 1024) return std::to_string(bytes / 1024) + " KB";
+    return std::to_string(bytes) + " B";
+}
+
+static bool pinToCpu(int cpu) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return sched_setaffinity(0, sizeof(set), &set) == 0;
+}
+
+int main(int argc, char* argv[]) {
+    BenchOptions options;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--cpu" && hasValue) options.cpu = std::atoi(argv[++i]);
+        else if ((arg == "--reps" || arg == "-r") && hasValue) options.repetitions = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--min-time" && hasValue) options.minSeconds = std::atof(argv[++i]);
+        else if (arg == "--warmup" && hasValue) options.warmupSeconds = std::atof(argv[++i]);
+        else if (arg == "--max-size" && hasValue) options.maxBytes = std::strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--filter" && hasValue) options.filter = argv[++i];
+        else if (arg == "--json" && hasValue) options.jsonFile = argv[++i];
+        else {
+            std::cout << "Usage: kernel-bench [options]" << std::endl;
+            std::cout << "  --cpu N          Pin to core N, -1 to leave unpinned (default: 0)" << std::endl;
+            std::cout << "  --reps, -r N     Timed repetitions per case (default: 5)" << std::endl;
+            std::cout << "  --min-time SEC   Shortest repetition (default: 0.05)" << std::endl;
+            std::cout << "  --warmup SEC     Untimed warmup per case (default: 0.1)" << std::endl;
+            std::cout << "  --max-size BYTES Largest input in the size sweep (default: 16777216)" << std::endl;
+            std::cout << "  --filter TEXT    Only kernels whose name contains TEXT" << std::endl;
+            std::cout << "  --json FILE      Write results as JSON" << std::endl;
+            return arg == "--help" || arg == "-h" ? 0 : 1;
+        }
+    }
+
+    if (options.cpu >= 0 && !pinToCpu(options.cpu)) {
+        std::cerr << "⚠️  Cannot pin to CPU " << options.cpu << ", running unpinned" << std::endl;
+        options.cpu = -1;
+    }
+
+    std::vector<size_t> sizes;
+    for (size_t bytes = 64; bytes <= options.maxBytes; bytes *= 4) sizes.push_back(bytes);
+
+    // Inputs live as long as the cases that reference them
+    std::vector<std::unique_ptr<std::string>> inputs;
+    auto input = [&](std::string value) -> std::string& {
+        inputs.push_back(std::make_unique<std::string>(std::move(value)));
+        return *inputs.back();
+    };
+
+    std::unique_ptr<TallyLedger> ledger;
+    bool forward = true;
+    PeerNetwork network("10.0.0.1");
+    network.addPeer("bench_peer", "10.0.0.2");
+
+    std::vector<BenchCase> cases;
+    // Alternating user -> network and back keeps every transfer valid; a fresh ledger per
+    // repetition keeps the transaction log from growing across the run
+    cases.push_back({"TallyLedger::transfer", 0,
+                     [&] {
+                         forward = !forward;
+                         sink += ledger->transfer(forward ? "network" : "user", forward ? "user" : "network", 1);
+                     },
+                     [&] {
+                         ledger = std::make_unique<TallyLedger>();
+                         forward = true;
+                     }});
+    TallyLedger hasher;
+    // Loop locals are captured by value: the cases run after the loop ends
+    for (size_t bytes : sizes) {
+        const std::string* data = &input(text(bytes));
+        const std::string* page = &input(html(bytes));
+        std::string* encrypted = &input("");
+        std::string* scratch = &input(std::string(bytes, 'x'));
+
+        cases.push_back({"TallyLedger::generateHash", bytes,
+                         [&hasher, data] { sink += hasher.generateHash(*data).size(); }, nullptr});
+        cases.push_back({"fingerprintContent", bytes,
+                         [&hasher, page] {
+                             auto hash = [&hasher](const std::string& data) { return hasher.generateHash(data); };
+                             sink += fingerprintContent(*page, "/index.html", hash).size();
+                         },
+                         nullptr});
+        // Through the public wrappers, so each call also takes the (uncontended) peers_mutex
+        cases.push_back({"PeerNetwork::encryptMessage", bytes,
+                         [&network, data] { sink += network.sendSecureMessage("bench_peer", *data).size(); }, nullptr});
+        cases.push_back({"PeerNetwork::decryptMessage", bytes,
+                         [&network, encrypted] { sink += network.receiveSecureMessage("bench_peer", *encrypted).size(); },
+                         [&network, data, encrypted] { *encrypted = network.sendSecureMessage("bench_peer", *data); }});
+        cases.push_back({"CaesarCipher::encrypt", bytes, [data] { sink += CaesarCipher::encrypt(*data).size(); }, nullptr});
+        cases.push_back({"CaesarCipher::decrypt", bytes, [data] { sink += CaesarCipher::decrypt(*data).size(); }, nullptr});
+        cases.push_back({"tally_hash_data", bytes, [data] { sink += tally_hash_data(data->data(), data->size()); }, nullptr});
+        cases.push_back({"tally_secure_zero", bytes,
+                         [scratch] {
+                             tally_secure_zero(&(*scratch)[0], scratch->size());
+                             sink += (*scratch)[0];
+                         },
+                         nullptr});
+    }
+    std::stable_sort(cases.begin(), cases.end(),
+                     [](const BenchCase& a, const BenchCase& b) { return a.kernel < b.kernel; });
+
+    std::cout << "⚡ Kernel microbenchmarks (" << options.repetitions << " x >=" << options.minSeconds << "s, "
+              << (options.cpu >= 0 ? "pinned to CPU " + std::to_string(options.cpu) : std::string("unpinned"))
+              << ")" << std::endl;
+    std::cout << std::left << std::setw(30) << "kernel" << std::right << std::setw(8) << "size" << std::setw(14)
+              << "median ns" << std::setw(10) << "stddev%" << std::setw(12) << "MB/s" << std::endl;
+
+    std::vector<BenchResult> results;
+    for (const BenchCase& bench : cases) {
+        if (!options.filter.empty() && bench.kernel.find(options.filter) == std::string::npos) continue;
+        BenchResult result = measure(bench, options);
+        results.push_back(result);
+        std::cout << std::left << std::setw(30) << result.kernel << std::right << std::setw(8)
+                  << sizeLabel(result.bytes) << std::fixed << std::setprecision(1) << std::setw(14)
+                  << result.medianNs << std::setw(10) << 100 * result.stddevNs / result.medianNs << std::setw(12);
+        if (result.bytes) std::cout << result.bytes / result.medianNs * 1e3;
+        else std::cout << "-";
+        std::cout << std::endl;
+    }
+
+    if (!options.jsonFile.empty()) {
+        std::ofstream json(options.jsonFile);
+        if (!json) {
+            std::cerr << "❌ Cannot write " << options.jsonFile << std::endl;
+            return 1;
+        }
+        json << std::fixed << std::setprecision(3) << "{\"cpu\":" << options.cpu << ",\"repetitions\":"
+             << options.repetitions << ",\"min_time_s\":" << options.minSeconds << ",\"results\":[";
+        for (size_t i = 0; i < results.size(); i++) {
+            const BenchResult& r = results[i];
+            json << (i ? "," : "") << "\n{\"kernel\":\"" << r.kernel << "\",\"bytes\":" << r.bytes
+                 << ",\"iterations\":" << r.iterations << ",\"ns_per_op\":{\"min\":" << r.minNs
+                 << ",\"median\":" << r.medianNs << ",\"mean\":" << r.meanNs << ",\"stddev\":" << r.stddevNs
+                 << "},\"mb_per_s\":" << (r.bytes ? r.bytes / r.medianNs * 1e3 : 0) << "}";
+        }
+        json << "\n]}" << std::endl;
+        std::cout << "💾 Results written to " << options.jsonFile << std::endl;
+    }
+    return 0;
+}
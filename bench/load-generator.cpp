@@ -0,0 +1,410 @@
+// HTTP load generator: drives a weighted request mix over many connections and reports
+// throughput plus latency percentiles. Build and run against a local server with:
+// make bench
+
+#include <algorithm>
+#include <arpa/inet.h>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <random>
+#include <sstream>
+#include <string>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+struct MixEntry {
+    std::string path;
+    int weight;
+};
+
+struct LoadOptions {
+    std::string host = "127.0.0.1";
+    int port = 8080;
+    int connections = 64;
+    int threads = 0; // 0 = one per core, at most 4
+    double duration = 10;
+    double warmup = 1;
+    bool keepAlive = true;
+    bool gzip = false;
+    std::vector<MixEntry> mix;
+    std::string label;
+    std::string jsonFile;
+};
+
+// Static pages and assets, tally reads and writes, and network reads
+static const std::vector<MixEntry> DEFAULT_MIX = {
+    {"/index.html", 20}, {"/tally.html", 10}, {"/icon.svg", 10},
+    {"/api/tally/status", 30}, {"/api/tally/combine", 2}, {"/api/tally/separate", 2},
+    {"/api/server/info", 5}, {"/api/network/peers", 10}, {"/api/network/status", 10},
+    {"/missing.txt", 1},
+};
+
+struct ThreadResult {
+    std::vector<uint64_t> latencies; // nanoseconds, measured requests only
+    std::map<int, uint64_t> statuses;
+    uint64_t bytes = 0;
+    uint64_t errors = 0;   // connect failures, resets and malformed responses
+    uint64_t connects = 0;
+};
+
+// One client connection: send a request, read the whole response, repeat
+struct ClientConnection {
+    int fd = -1;
+    bool connected = false;
+    std::string out;
+    size_t sent = 0;
+    std::string in;
+    std::chrono::steady_clock::time_point started;
+};
+
+class LoadWorker {
+public:
+    LoadWorker(const LoadOptions& options, const std::vector<std::string>& requests,
+               const std::vector<int>& cumulative, int connections, unsigned seed)
+        : options(options), requests(requests), cumulative(cumulative), connections(connections), rng(seed) {}
+
+    void run(std::chrono::steady_clock::time_point measureFrom, std::chrono::steady_clock::time_point until) {
+        epollFd = epoll_create1(0);
+        clients.resize(connections);
+        for (size_t i = 0; i < clients.size(); i++) startRequest(i);
+
+        epoll_event events[256];
+        while (std::chrono::steady_clock::now() < until) {
+            int n = epoll_wait(epollFd, events, 256, 100);
+            for (int e = 0; e < n; e++) {
+                size_t index = events[e].data.u64;
+                ClientConnection& client = clients[index];
+                if (events[e].events & (EPOLLERR | EPOLLHUP) && !(events[e].events & EPOLLIN)) {
+                    fail(index);
+                    continue;
+                }
+                if (!client.connected) client.connected = true;
+                if (client.sent < client.out.size() && !writeRequest(index)) continue;
+                if (events[e].events & EPOLLIN) readResponse(index, measureFrom);
+            }
+        }
+        for (ClientConnection& client : clients) {
+            if (client.fd >= 0) close(client.fd);
+        }
+        close(epollFd);
+    }
+
+    ThreadResult result;
+
+private:
+    const LoadOptions& options;
+    const std::vector<std::string>& requests;
+    const std::vector<int>& cumulative;
+    int connections;
+    std::mt19937 rng;
+    int epollFd = -1;
+    std::vector<ClientConnection> clients;
+
+    const std::string& pickRequest() {
+        int ticket = std::uniform_int_distribution<int>(1, cumulative.back())(rng);
+        size_t index = std::lower_bound(cumulative.begin(), cumulative.end(), ticket) - cumulative.begin();
+        return requests[index];
+    }
+
+    bool openConnection(size_t index) {
+        ClientConnection& client = clients[index];
+        client.fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (client.fd < 0) return false;
+        int one = 1;
+        setsockopt(client.fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(options.port);
+        inet_pton(AF_INET, options.host.c_str(), &address.sin_addr);
+        if (connect(client.fd, (sockaddr*)&address, sizeof(address)) < 0 && errno != EINPROGRESS) {
+            close(client.fd);
+            client.fd = -1;
+            return false;
+        }
+        client.connected = false;
+        epoll_event event{};
+        event.events = EPOLLIN | EPOLLOUT | EPOLLET;
+        event.data.u64 = index;
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, client.fd, &event);
+        result.connects++;
+        return true;
+    }
+
+    void closeConnection(size_t index) {
+        ClientConnection& client = clients[index];
+        if (client.fd < 0) return;
+        epoll_ctl(epollFd, EPOLL_CTL_DEL, client.fd, nullptr);
+        close(client.fd);
+        client.fd = -1;
+    }
+
+    // Latency runs from here, so in close mode it includes the TCP handshake
+    void startRequest(size_t index) {
+        ClientConnection& client = clients[index];
+        client.out = pickRequest();
+        client.sent = 0;
+        client.in.clear();
+        client.started = std::chrono::steady_clock::now();
+        if (client.fd < 0 && !openConnection(index)) {
+            result.errors++;
+            return;
+        }
+        if (client.connected) writeRequest(index);
+    }
+
+    void fail(size_t index) {
+        result.errors++;
+        closeConnection(index);
+        startRequest(index);
+    }
+
+    // False if the connection failed
+    bool writeRequest(size_t index) {
+        ClientConnection& client = clients[index];
+        while (client.sent < client.out.size()) {
+            ssize_t n = send(client.fd, client.out.data() + client.sent, client.out.size() - client.sent, MSG_NOSIGNAL);
+            if (n > 0) {
+                client.sent += n;
+                continue;
+            }
+            if (n < 0 && errno == EINTR) continue;
+            if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return true;
+            fail(index);
+            return false;
+        }
+        return true;
+    }
+
+    void readResponse(size_t index, std::chrono::steady_clock::time_point measureFrom) {
+        ClientConnection& client = clients[index];
+        char buffer[65536];
+        bool peerClosed = false;
+        while (true) {
+            ssize_t n = recv(client.fd, buffer, sizeof(buffer), 0);
+            if (n > 0) {
+                client.in.append(buffer, n);
+                continue;
+            }
+            if (n < 0 && errno == EINTR) continue;
+            if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+            if (n == 0) {
+                peerClosed = true;
+                break;
+            }
+            fail(index);
+            return;
+        }
+
+        int status = 0;
+        size_t length = 0;
+        bool closeAfter = !options.keepAlive;
+        int complete = parseResponse(client.in, status, length, closeAfter);
+        if (complete < 0 || (complete == 0 && peerClosed)) {
+            // A keep-alive connection the server closed between requests is simply reopened
+            if (peerClosed && client.in.empty()) {
+                closeConnection(index);
+                startRequest(index);
+            } else {
+                fail(index);
+            }
+            return;
+        }
+        if (complete == 0) return;
+
+        auto now = std::chrono::steady_clock::now();
+        if (client.started >= measureFrom) {
+            result.latencies.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(now - client.started).count());
+            result.statuses[status]++;
+            result.bytes += length;
+        }
+        if (closeAfter || peerClosed) closeConnection(index);
+        startRequest(index);
+    }
+
+    // 1 when `in` holds a whole response, 0 if more is needed, -1 if it is malformed.
+    // The server always frames bodies with Content-Length.
+    static int parseResponse(const std::string& in, int& status, size_t& length, bool& closeAfter) {
+        size_t headerEnd = in.find("\r\n\r\n");
+        if (headerEnd == std::string::npos) return 0;
+        if (in.compare(0, 9, "HTTP/1.1 ") != 0 || in.size() < 12) return -1;
+        status = std::atoi(in.c_str() + 9);
+
+        size_t contentLength = 0;
+        size_t lineStart = in.find("\r\n") + 2;
+        while (lineStart < headerEnd) {
+            size_t lineEnd = in.find("\r\n", lineStart);
+            std::string line = in.substr(lineStart, lineEnd - lineStart);
+            std::transform(line.begin(), line.end(), line.begin(), ::tolower);
+            if (line.compare(0, 15, "content-length:") == 0) {
+                contentLength = std::strtoull(line.c_str() + 15, nullptr, 10);
+            } else if (line.compare(0, 11, "connection:") == 0 && line.find("close") != std::string::npos) {
+                closeAfter = true;
+            }
+            lineStart = lineEnd + 2;
+        }
+        length = headerEnd + 4 + contentLength;
+        if (in.size() < length) return 0;
+        return in.size() == length ? 1 : -1; // nothing is pipelined, so extra bytes are an error
+    }
+};
+
+static bool parseMix(const std::string& text, std::vector<MixEntry>& mix) {
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        size_t colon = item.rfind(':');
+        int weight = colon == std::string::npos ? 1 : std::atoi(item.c_str() + colon + 1);
+        std::string path = item.substr(0, colon);
+        if (path.empty() || path[0] != '/' || weight <= 0) return false;
+        mix.push_back({path, weight});
+    }
+    return !mix.empty();
+}
+
+static double percentile(const std::vector<uint64_t>& sorted, double fraction) {
+    if (sorted.empty()) return 0;
+    size_t index = std::min(sorted.size() - 1, (size_t)(fraction * sorted.size()));
+    return sorted[index] / 1e6;
+}
+
+static void usage() {
+    std::cout << "Usage: load-generator [options]" << std::endl;
+    std::cout << "  --host ADDR         Server IPv4 address (default: 127.0.0.1)" << std::endl;
+    std::cout << "  --port, -p PORT     Server port (default: 8080)" << std::endl;
+    std::cout << "  --connections, -c N Concurrent connections (default: 64)" << std::endl;
+    std::cout << "  --threads, -t N     Client threads (default: one per core, at most 4)" << std::endl;
+    std::cout << "  --duration, -d SEC  Measured seconds (default: 10)" << std::endl;
+    std::cout << "  --warmup SEC        Unmeasured seconds before that (default: 1)" << std::endl;
+    std::cout << "  --close             New connection per request instead of keep-alive" << std::endl;
+    std::cout << "  --gzip              Send Accept-Encoding: gzip" << std::endl;
+    std::cout << "  --mix PATH:W,...    Weighted request mix (default: static, tally and network)" << std::endl;
+    std::cout << "  --label NAME        Scenario name in the JSON output" << std::endl;
+    std::cout << "  --json FILE         Write results as JSON" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    LoadOptions options;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--host" && hasValue) options.host = argv[++i];
+        else if ((arg == "--port" || arg == "-p") && hasValue) options.port = std::atoi(argv[++i]);
+        else if ((arg == "--connections" || arg == "-c") && hasValue) options.connections = std::atoi(argv[++i]);
+        else if ((arg == "--threads" || arg == "-t") && hasValue) options.threads = std::atoi(argv[++i]);
+        else if ((arg == "--duration" || arg == "-d") && hasValue) options.duration = std::atof(argv[++i]);
+        else if (arg == "--warmup" && hasValue) options.warmup = std::atof(argv[++i]);
+        else if (arg == "--close") options.keepAlive = false;
+        else if (arg == "--gzip") options.gzip = true;
+        else if (arg == "--label" && hasValue) options.label = argv[++i];
+        else if (arg == "--json" && hasValue) options.jsonFile = argv[++i];
+        else if (arg == "--mix" && hasValue) {
+            if (!parseMix(argv[++i], options.mix)) {
+                std::cerr << "❌ Bad --mix, expected /path:weight,/path:weight" << std::endl;
+                return 1;
+            }
+        } else {
+            usage();
+            return arg == "--help" || arg == "-h" ? 0 : 1;
+        }
+    }
+    if (options.mix.empty()) options.mix = DEFAULT_MIX;
+    if (options.threads <= 0) options.threads = std::clamp((int)std::thread::hardware_concurrency(), 1, 4);
+    options.threads = std::min(options.threads, std::max(1, options.connections));
+    if (options.label.empty()) options.label = options.keepAlive ? "keep-alive" : "close";
+
+    // Requests are formatted once; workers pick one by weight for every send
+    std::vector<std::string> requests;
+    std::vector<int> cumulative;
+    int total = 0;
+    for (const MixEntry& entry : options.mix) {
+        std::string request = "GET " + entry.path + " HTTP/1.1\r\nHost: " + options.host + ":" +
+                              std::to_string(options.port) + "\r\n";
+        if (options.gzip) request += "Accept-Encoding: gzip\r\n";
+        if (!options.keepAlive) request += "Connection: close\r\n";
+        requests.push_back(request + "\r\n");
+        cumulative.push_back(total += entry.weight);
+    }
+
+    std::cout << "🚀 " << options.label << ": " << options.connections << " connections on " << options.threads
+              << " threads, " << options.warmup << "s warmup + " << options.duration << "s against "
+              << options.host << ":" << options.port << std::endl;
+
+    auto measureFrom = std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                                               std::chrono::duration<double>(options.warmup));
+    auto until = measureFrom + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                   std::chrono::duration<double>(options.duration));
+    std::vector<std::unique_ptr<LoadWorker>> workers;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < options.threads; t++) {
+        int share = options.connections / options.threads + (t < options.connections % options.threads ? 1 : 0);
+        workers.push_back(std::make_unique<LoadWorker>(options, requests, cumulative, share, 12345u + t));
+    }
+    for (auto& worker : workers) {
+        threads.emplace_back([&worker, measureFrom, until] { worker->run(measureFrom, until); });
+    }
+    for (std::thread& thread : threads) thread.join();
+
+    std::vector<uint64_t> latencies;
+    std::map<int, uint64_t> statuses;
+    uint64_t bytes = 0, errors = 0, connects = 0;
+    for (const auto& worker : workers) {
+        latencies.insert(latencies.end(), worker->result.latencies.begin(), worker->result.latencies.end());
+        for (const auto& status : worker->result.statuses) statuses[status.first] += status.second;
+        bytes += worker->result.bytes;
+        errors += worker->result.errors;
+        connects += worker->result.connects;
+    }
+    std::sort(latencies.begin(), latencies.end());
+    double rps = latencies.size() / options.duration;
+    double mean = 0;
+    for (uint64_t latency : latencies) mean += latency / 1e6;
+    if (!latencies.empty()) mean /= latencies.size();
+
+    std::cout << std::fixed << std::setprecision(0) << "📊 " << latencies.size() << " requests, " << rps
+              << " req/s, " << std::setprecision(1) << bytes / options.duration / 1e6 << " MB/s, " << errors
+              << " errors" << std::endl;
+    std::cout << std::setprecision(3) << "⏱️  latency ms: p50 " << percentile(latencies, 0.5) << "  p99 "
+              << percentile(latencies, 0.99) << "  p999 " << percentile(latencies, 0.999) << "  max "
+              << (latencies.empty() ? 0 : latencies.back() / 1e6) << std::endl;
+    std::cout << "📋 status:";
+    for (const auto& status : statuses) std::cout << " " << status.first << "=" << status.second;
+    std::cout << std::endl;
+
+    if (!options.jsonFile.empty()) {
+        std::ofstream json(options.jsonFile);
+        if (!json) {
+            std::cerr << "❌ Cannot write " << options.jsonFile << std::endl;
+            return 1;
+        }
+        json << std::fixed << std::setprecision(3) << "{\"label\":\"" << options.label << "\",\"connections\":"
+             << options.connections << ",\"threads\":" << options.threads << ",\"keep_alive\":"
+             << (options.keepAlive ? "true" : "false") << ",\"gzip\":" << (options.gzip ? "true" : "false")
+             << ",\"duration_s\":" << options.duration << ",\"requests\":" << latencies.size()
+             << ",\"rps\":" << rps << ",\"bytes\":" << bytes << ",\"errors\":" << errors
+             << ",\"connects\":" << connects << ",\"latency_ms\":{\"mean\":" << mean
+             << ",\"p50\":" << percentile(latencies, 0.5) << ",\"p90\":" << percentile(latencies, 0.9)
+             << ",\"p99\":" << percentile(latencies, 0.99) << ",\"p999\":" << percentile(latencies, 0.999)
+             << ",\"max\":" << (latencies.empty() ? 0 : latencies.back() / 1e6) << "},\"status\":{";
+        bool first = true;
+        for (const auto& status : statuses) {
+            json << (first ? "" : ",") << "\"" << status.first << "\":" << status.second;
+            first = false;
+        }
+        json << "}}" << std::endl;
+    }
+    return errors > latencies.size() / 100 ? 2 : 0; // more than 1% failed
+}
@@ -0,0 +1,54 @@
+#!/bin/bash
+# Throughput and latency of a locally started server for the standard request mix, in
+# every I/O backend with keep-alive and connection-per-request clients. Results go to one
+# JSON file for before/after comparisons; MODELS="epoll uring" compares just those two.
+# Usage: bench/load-mix.sh [server-binary] [load-generator] [json-out]   (run via: make bench)
+SERVER=${1:-./tally-server}
+LOADGEN=${2:-bench/load-generator}
+OUT=${3:-bench-results.json}
+PORT=${PORT:-18090}
+DURATION=${DURATION:-5}
+CONNECTIONS=${CONNECTIONS:-64}
+MODELS=${MODELS:-threads epoll uring}
+
+RUNS=()
+TMP=$(mktemp -d)
+PID=
+trap 'kill $PID 2>/dev/null; rm -rf "$TMP"' EXIT
+
+for MODEL in $MODELS; do
+    "$SERVER" --daemon --port "$PORT" --io-model "$MODEL" > /dev/null 2>&1 &
+    PID=$!
+    for _ in $(seq 50); do
+        curl -s -o /dev/null "http://localhost:$PORT/api/tally/status" && break
+        sleep 0.1
+    done
+    # The server falls back to epoll where io_uring is unavailable; label what actually ran
+    ACTUAL=$(curl -s "http://localhost:$PORT/api/server/stats" | sed -n 's/.*"io_model":"\([a-z]*\)".*/\1/p')
+    if [ -n "$ACTUAL" ] && [ "$ACTUAL" != "$MODEL" ]; then
+        echo "⚠️  --io-model $MODEL ran as $ACTUAL"
+        MODEL=$ACTUAL
+    fi
+
+    for CLIENT in keep-alive close; do
+        FLAGS=()
+        [ "$CLIENT" = close ] && FLAGS+=(--close)
+        "$LOADGEN" --port "$PORT" --connections "$CONNECTIONS" --duration "$DURATION" \
+            --label "$MODEL/$CLIENT" --json "$TMP/$MODEL-$CLIENT.json" "${FLAGS[@]}" || exit 1
+        RUNS+=("$(cat "$TMP/$MODEL-$CLIENT.json")")
+    done
+
+    kill $PID
+    wait $PID 2>/dev/null
+done
+
+COMMIT=$(git rev-parse --short HEAD 2>/dev/null || echo unknown)
+{
+    printf '{"commit":"%s","date":"%s","cores":%s,"runs":[\n' "$COMMIT" "$(date -u +%Y-%m-%dT%H:%M:%SZ)" "$(nproc)"
+    for i in "${!RUNS[@]}"; do
+        [ "$i" -gt 0 ] && printf ',\n'
+        printf '%s' "${RUNS[$i]}"
+    done
+    printf '\n]}\n'
+} > "$OUT"
+echo "💾 Results written to $OUT"
@@ -0,0 +1,108 @@
+// Dispatch-cost microbenchmark for the tally-server route table
+// Build and run with: make route-bench
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "../tally-routes.h"
+
+static volatile long long sink;
+
+// The if/else chain handleRequest used before tally-routes.h, kept for comparison
+static int dispatchLegacy(const std::string& path) {
+    if (path == "/api/tally/combine") return (int)TallyRoute::TallyCombine;
+    else if (path == "/api/tally/separate") return (int)TallyRoute::TallySeparate;
+    else if (path == "/api/tally/status") return (int)TallyRoute::TallyStatus;
+    else if (path == "/api/server/stats") return (int)TallyRoute::ServerStats;
+    else if (path == "/api/server/info") return (int)TallyRoute::ServerInfo;
+    else if (path == "/api/network/peers") return (int)TallyRoute::NetworkPeers;
+    else if (path == "/api/network/add-peer") return (int)TallyRoute::NetworkAddPeer;
+    else if (path == "/api/network/info") return (int)TallyRoute::NetworkInfo;
+    else if (path == "/api/network/public-key") return (int)TallyRoute::NetworkPublicKey;
+    else if (path == "/api/network/discover") return (int)TallyRoute::NetworkDiscover;
+    else if (path == "/api/network/challenge") return (int)TallyRoute::NetworkChallenge;
+    else if (path.find("/api/network/send/") == 0) {
+        sink += path.substr(path.find_last_of('/') + 1).size();
+        return (int)TallyRoute::NetworkSend;
+    }
+    else if (path == "/api/network/scan") return (int)TallyRoute::NetworkScan;
+    else if (path == "/api/network/optimize") return (int)TallyRoute::NetworkOptimize;
+    else if (path == "/api/network/status") return (int)TallyRoute::NetworkStatus;
+    return -1;
+}
+
+static int dispatchTable(const std::string& path) {
+    RouteMatch match = TALLY_ROUTES.match("GET", path);
+    sink += match.param.size();
+    return match.id;
+}
+
+template <typename Dispatch>
+static double nsPerDispatch(const std::vector<std::string>& paths, double seconds, Dispatch dispatch) {
+    for (int i = 0; i < 1000; i++) {
+        for (const auto& path : paths) sink += dispatch(path);
+    }
+
+    long long dispatched = 0;
+    auto start = std::chrono::steady_clock::now();
+    auto deadline = start + std::chrono::duration<double>(seconds);
+    while (std::chrono::steady_clock::now() < deadline) {
+        for (int i = 0; i < 256; i++) {
+            for (const auto& path : paths) sink += dispatch(path);
+        }
+        dispatched += 256 * (long long)paths.size();
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return elapsed * 1e9 / dispatched;
+}
+
+int main(int argc, char* argv[]) {
+    double seconds = 0.5;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if ((arg == "--seconds" || arg == "-s") && i + 1 < argc) {
+            seconds = std::atof(argv[++i]);
+        }
+    }
+
+    struct BenchCase {
+        std::string name;
+        std::vector<std::string> paths;
+    };
+    std::vector<BenchCase> cases = {
+        {"first route (combine)", {"/api/tally/combine"}},
+        {"hot route (status)", {"/api/tally/status"}},
+        {"last route (network/status)", {"/api/network/status"}},
+        {"parameter (send/{peer})", {"/api/network/send/peer_1718000000"}},
+        {"static miss (/index.html)", {"/index.html"}},
+        {"mixed API + static", {"/api/tally/status", "/index.html", "/api/server/stats", "/tally.js",
+                                "/api/network/peers", "/assets/logo.png", "/api/network/send/peer_7",
+                                "/api/network/status"}},
+    };
+
+    // Both dispatchers must agree before their timings mean anything
+    for (const auto& bench : cases) {
+        for (const auto& path : bench.paths) {
+            if (dispatchLegacy(path) != dispatchTable(path)) {
+                std::cerr << "❌ Dispatch mismatch for " << path << std::endl;
+                return 1;
+            }
+        }
+    }
+
+    std::cout << "⚡ Route dispatch cost (" << seconds << "s per case)" << std::endl;
+    std::cout << std::left << std::setw(32) << "case" << std::right << std::setw(14) << "if/else ns"
+              << std::setw(14) << "table ns" << std::endl;
+
+    for (const auto& bench : cases) {
+        double legacy = nsPerDispatch(bench.paths, seconds, dispatchLegacy);
+        double table = nsPerDispatch(bench.paths, seconds, dispatchTable);
+        std::cout << std::left << std::setw(32) << bench.name << std::right << std::fixed
+                  << std::setprecision(1) << std::setw(14) << legacy << std::setw(14) << table << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,250 @@
+#ifndef BYTE_RANGE_H
+#define BYTE_RANGE_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
+#include <fcntl.h>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unistd.h>
+#include <vector>
+#include "conditional.h"
+#include "http-parser.h"
+#include "send-queue.h"
+
+// Range requests (RFC 9110 section 14): deciding whether a GET is answered with the
+// whole representation, 206 Partial Content or 416, and framing the 206 body. The
+// bytes themselves are queued by the caller, so file-backed bodies stay on sendfile.
+class ByteRange {
+public:
+    struct Span {
+        uint64_t first;
+        uint64_t length;
+    };
+
+    enum class Outcome { Full, Partial, Unsatisfiable };
+
+    // More ranges than this (after coalescing) are answered with the whole body
+    static constexpr size_t MAX_RANGES = 16;
+
+    // How to answer `request` for a representation of `size` bytes. Full when there is no
+    // usable Range header or If-Range does not match the strong validator `etag` (or
+    // `lastModified`); Partial with ranges sorted and coalesced; Unsatisfiable for 416.
+    static Outcome evaluate(const HttpRequest& request, uint64_t size, std::string_view etag, time_t lastModified,
+                            std::vector<Span>& ranges) {
+        ranges.clear();
+        if (request.method != "GET") return Outcome::Full;
+        std::string_view header = request.header("Range");
+        if (header.empty()) return Outcome::Full;
+
+        std::string_view ifRange = request.header("If-Range");
+        if (!ifRange.empty() && !ifRangeMatches(ifRange, etag, lastModified)) return Outcome::Full;
+
+        // Unknown units and malformed sets are ignored rather than rejected
+        size_t equals = header.find('=');
+        if (equals == std::string_view::npos || !HttpRequest::equalsIgnoreCase(trim(header.substr(0, equals)), "bytes")) {
+            return Outcome::Full;
+        }
+        std::string_view list = header.substr(equals + 1);
+        bool anySpec = false;
+        while (!list.empty()) {
+            size_t comma = list.find(',');
+            std::string_view spec = trim(list.substr(0, comma));
+            list = comma == std::string_view::npos ? std::string_view() : list.substr(comma + 1);
+            if (spec.empty()) continue;
+            anySpec = true;
+            if (!parseSpec(spec, size, ranges)) {
+                ranges.clear();
+                return Outcome::Full;
+            }
+        }
+        if (!anySpec) return Outcome::Full;
+        if (ranges.empty()) return Outcome::Unsatisfiable;
+
+        coalesce(ranges);
+        return ranges.size() > MAX_RANGES ? Outcome::Full : Outcome::Partial;
+    }
+
+    // Content-Range value for one part, and for a 416
+    static std::string contentRange(const Span& span, uint64_t size) {
+        char buffer[80];
+        snprintf(buffer, sizeof(buffer), "bytes %llu-%llu/%llu", (unsigned long long)span.first,
+                 (unsigned long long)(span.first + span.length - 1), (unsigned long long)size);
+        return buffer;
+    }
+
+    static std::string unsatisfiedRange(uint64_t size) { return "bytes */" + std::to_string(size); }
+
+private:
+    static std::string_view trim(std::string_view text) {
+        while (!text.empty() && (text.front() == ' ' || text.front() == '\t')) text.remove_prefix(1);
+        while (!text.empty() && (text.back() == ' ' || text.back() == '\t')) text.remove_suffix(1);
+        return text;
+    }
+
+    // Decimal digits, saturating at UINT64_MAX; false if empty or not all digits
+    static bool parseNumber(std::string_view digits, uint64_t& value) {
+        if (digits.empty()) return false;
+        value = 0;
+        for (char c : digits) {
+            if (c < '0' || c > '9') return false;
+            uint64_t digit = (uint64_t)(c - '0');
+            value = value > (UINT64_MAX - digit) / 10 ? UINT64_MAX : value * 10 + digit;
+        }
+        return true;
+    }
+
+    // "first-last", "first-" or "-suffix"; unsatisfiable specs add nothing
+    static bool parseSpec(std::string_view spec, uint64_t size, std::vector<Span>& ranges) {
+        size_t dash = spec.find('-');
+        if (dash == std::string_view::npos) return false;
+        std::string_view firstText = trim(spec.substr(0, dash));
+        std::string_view lastText = trim(spec.substr(dash + 1));
+
+        uint64_t first, last;
+        if (firstText.empty()) {
+            uint64_t suffix;
+            if (!parseNumber(lastText, suffix)) return false;
+            if (suffix > 0 && size > 0) {
+                uint64_t length = std::min(suffix, size);
+                ranges.push_back({size - length, length});
+            }
+            return true;
+        }
+        if (!parseNumber(firstText, first)) return false;
+        if (lastText.empty()) {
+            last = UINT64_MAX;
+        } else if (!parseNumber(lastText, last) || last < first) {
+            return false;
+        }
+        if (first >= size) return true;
+        last = std::min(last, size - 1);
+        ranges.push_back({first, last - first + 1});
+        return true;
+    }
+
+    // Sort, then merge ranges that overlap or touch, so no byte is sent twice
+    static void coalesce(std::vector<Span>& ranges) {
+        if (ranges.size() < 2) return;
+        std::sort(ranges.begin(), ranges.end(), [](const Span& a, const Span& b) { return a.first < b.first; });
+        size_t out = 0;
+        for (size_t i = 1; i < ranges.size(); i++) {
+            Span& current = ranges[out];
+            uint64_t end = current.first + current.length;
+            if (ranges[i].first <= end) {
+                current.length = std::max(end, ranges[i].first + ranges[i].length) - current.first;
+            } else {
+                ranges[++out] = ranges[i];
+            }
+        }
+        ranges.resize(out + 1);
+    }
+
+    // If-Range needs a strong match: an entity tag equal to ours (neither weak), or a date
+    // equal to Last-Modified
+    static bool ifRangeMatches(std::string_view ifRange, std::string_view etag, time_t lastModified) {
+        ifRange = trim(ifRange);
+        if (ifRange.front() == '"' || ifRange.substr(0, 2) == "W/") {
+            return !etag.empty() && etag.substr(0, 2) != "W/" && ifRange == etag;
+        }
+        time_t date;
+        return lastModified != 0 && ConditionalRequest::parseHttpDate(ifRange, date) && date == lastModified;
+    }
+};
+
+// Head fields and body framing for a 206: one range is sent as is with Content-Range;
+// several become a multipart/byteranges body whose part heads are queued between the
+// caller's spans.
+class RangeResponse {
+public:
+    // contentType is the full Content-Type value of the whole representation
+    RangeResponse(std::vector<ByteRange::Span> ranges, std::string_view contentType, uint64_t size)
+        : ranges(std::move(ranges)) {
+        if (this->ranges.size() == 1) {
+            head = "Content-Type: " + std::string(contentType) + "\r\n"
+                   "Content-Length: " + std::to_string(this->ranges[0].length) + "\r\n"
+                   "Content-Range: " + ByteRange::contentRange(this->ranges[0], size) + "\r\n";
+            return;
+        }
+
+        std::string boundary = newBoundary();
+        uint64_t length = 0;
+        for (const ByteRange::Span& span : this->ranges) {
+            partHeads.push_back("\r\n--" + boundary + "\r\nContent-Type: " + std::string(contentType) +
+                                "\r\nContent-Range: " + ByteRange::contentRange(span, size) + "\r\n\r\n");
+            length += partHeads.back().size() + span.length;
+        }
+        closing = "\r\n--" + boundary + "--\r\n";
+        length += closing.size();
+        head = "Content-Type: multipart/byteranges; boundary=" + boundary + "\r\n"
+               "Content-Length: " + std::to_string(length) + "\r\n";
+    }
+
+    // Content-Type, Content-Length and, for one range, Content-Range lines
+    const std::string& headers() const { return head; }
+
+    // Queue the body, calling appendSpan(first, length) to queue each range's bytes
+    template <typename AppendSpan>
+    void appendBody(SendQueue& out, AppendSpan&& appendSpan) const {
+        for (size_t i = 0; i < ranges.size(); i++) {
+            if (!partHeads.empty()) out.append(partHeads[i]);
+            appendSpan(ranges[i].first, ranges[i].length);
+        }
+        if (!closing.empty()) out.append(closing);
+    }
+
+    // Body sliced from a shared buffer (e.g. a cached asset) without copying it
+    void appendBufferBody(SendQueue& out, const std::shared_ptr<const std::string>& bytes) const {
+        appendBody(out, [&](uint64_t first, uint64_t length) { out.append(bytes, first, length); });
+    }
+
+    // Body sent from `fd` with one sendfile segment per range. Takes ownership of fd; the
+    // queue closes each segment's descriptor, so every extra range gets a duplicate. On
+    // false (out of descriptors) nothing was queued.
+    bool appendFileBody(SendQueue& out, int fd) const {
+        std::vector<int> descriptors{fd};
+        while (descriptors.size() < ranges.size()) {
+            int copy = fcntl(fd, F_DUPFD_CLOEXEC, 0);
+            if (copy < 0) {
+                for (int descriptor : descriptors) close(descriptor);
+                return false;
+            }
+            descriptors.push_back(copy);
+        }
+        size_t next = 0;
+        appendBody(out, [&](uint64_t first, uint64_t length) {
+            out.appendFile(descriptors[next++], (off_t)first, length);
+        });
+        return true;
+    }
+
+private:
+    std::vector<ByteRange::Span> ranges;
+    std::vector<std::string> partHeads;
+    std::string closing;
+    std::string head;
+
+    // Random enough that it cannot be predicted and planted in a file's content
+    static std::string newBoundary() {
+        thread_local uint64_t state = (uint64_t)std::chrono::steady_clock::now().time_since_epoch().count() ^
+                                      (uint64_t)(uintptr_t)&state;
+        char buffer[40];
+        uint64_t parts[2];
+        for (uint64_t& part : parts) {
+            // splitmix64
+            state += 0x9E3779B97F4A7C15ULL;
+            uint64_t z = state;
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            part = z ^ (z >> 31);
+        }
+        snprintf(buffer, sizeof(buffer), "%016llx%016llx", (unsigned long long)parts[0], (unsigned long long)parts[1]);
+        return buffer;
+    }
+};
+
+#endif // BYTE_RANGE_H
@@ -0,0 +1,57 @@
+#ifndef CAESAR_CIPHER_H
+#define CAESAR_CIPHER_H
+
+#include <cctype>
+#include <cstddef>
+#include <string>
+
+// Caesar cipher the editor uses for files saved through /api/save: letters rotate within
+// their case and digits within 0-9; everything else passes through unchanged.
+class CaesarCipher {
+public:
+    static std::string encrypt(const std::string& text, int shift = 6) {
+        std::string result(text);
+        encryptInPlace(&result[0], result.size(), shift);
+        return result;
+    }
+
+    // Every byte is encoded on its own, so a stream can be encrypted in chunks of any size
+    static void encryptInPlace(char* data, size_t length, int shift = 6) {
+        for (size_t i = 0; i < length; i++) {
+            char c = data[i];
+            if (isalpha(c)) {
+                char base = islower(c) ? 'a' : 'A';
+                c = (c - base + shift) % 26 + base;
+            } else if (isdigit(c)) {
+                // Handle negative modulo for digits
+                int digit = c - '0';
+                digit = (digit + shift) % 10;
+                if (digit < 0) digit += 10;
+                c = '0' + digit;
+            }
+            // Leave other characters unchanged
+            data[i] = c;
+        }
+    }
+
+    static std::string decrypt(const std::string& text, int shift = 6) {
+        std::string result;
+        for (char c : text) {
+            if (isalpha(c)) {
+                char base = islower(c) ? 'a' : 'A';
+                c = (c - base - shift + 26) % 26 + base;
+            } else if (isdigit(c)) {
+                // Handle negative modulo for digits
+                int digit = c - '0';
+                digit = (digit - shift) % 10;
+                if (digit < 0) digit += 10;
+                c = '0' + digit;
+            }
+            // Leave other characters unchanged
+            result += c;
+        }
+        return result;
+    }
+};
+
+#endif // CAESAR_CIPHER_H
@@ -0,0 +1,148 @@
+#ifndef COMPRESSION_H
+#define COMPRESSION_H
+
+#include <cctype>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <zlib.h>
+
+enum class ContentCoding { Identity, Gzip, Deflate };
+
+// zlib helpers for HTTP content coding: Accept-Encoding negotiation plus reusable
+// per-thread deflate streams, so compressing a response never pays deflateInit.
+class Compression {
+public:
+    static const char* codingName(ContentCoding coding) {
+        switch (coding) {
+            case ContentCoding::Gzip: return "gzip";
+            case ContentCoding::Deflate: return "deflate";
+            default: return "identity";
+        }
+    }
+
+    // Worth compressing: text formats, not already-compressed images
+    static bool compressibleType(std::string_view contentType) {
+        return contentType.substr(0, 5) == "text/" || contentType == "application/javascript" ||
+               contentType == "application/json" || contentType == "image/svg+xml";
+    }
+
+    // Pick the coding with the highest q-value from an Accept-Encoding header,
+    // preferring gzip on ties. "*" applies to codings not listed explicitly.
+    static ContentCoding negotiate(std::string_view acceptEncoding) {
+        double gzip = -1, deflate = -1, wildcard = -1;
+        while (!acceptEncoding.empty()) {
+            size_t comma = acceptEncoding.find(',');
+            std::string_view item = trim(acceptEncoding.substr(0, comma));
+            acceptEncoding = comma == std::string_view::npos ? std::string_view() : acceptEncoding.substr(comma + 1);
+
+            double q = 1.0;
+            size_t semicolon = item.find(';');
+            std::string_view name = trim(item.substr(0, semicolon));
+            if (semicolon != std::string_view::npos) {
+                std::string_view param = trim(item.substr(semicolon + 1));
+                if (param.size() > 2 && (param[0] == 'q' || param[0] == 'Q') && param[1] == '=') {
+                    q = std::strtod(std::string(param.substr(2)).c_str(), nullptr);
+                }
+            }
+            if (equalsIgnoreCase(name, "gzip") || equalsIgnoreCase(name, "x-gzip")) gzip = q;
+            else if (equalsIgnoreCase(name, "deflate")) deflate = q;
+            else if (name == "*") wildcard = q;
+        }
+        if (gzip < 0) gzip = wildcard;
+        if (deflate < 0) deflate = wildcard;
+
+        if (gzip > 0 && gzip >= deflate) return ContentCoding::Gzip;
+        if (deflate > 0) return ContentCoding::Deflate;
+        return ContentCoding::Identity;
+    }
+
+    // Compress a whole body into `out` (appending) with this thread's stream for (coding, level).
+    // `out` may be any contiguous string type, e.g. an arena-backed std::pmr::string.
+    template <typename String>
+    static bool compress(std::string_view input, ContentCoding coding, int level, String& out) {
+        Stream* stream = threadStream(coding, level);
+        if (!stream || !stream->reset()) return false;
+        out.reserve(out.size() + deflateBound(&stream->z, input.size()));
+        return stream->write(input, out, true);
+    }
+
+    // Incremental compression of a body produced in pieces; write() may be called
+    // repeatedly and finish() flushes the trailer.
+    class Stream {
+    public:
+        Stream(ContentCoding coding, int level) : ok(false) {
+            z.zalloc = Z_NULL;
+            z.zfree = Z_NULL;
+            z.opaque = Z_NULL;
+            // windowBits 15 + 16 selects the gzip wrapper, plain 15 the zlib ("deflate") one
+            int windowBits = coding == ContentCoding::Gzip ? 15 + 16 : 15;
+            ok = deflateInit2(&z, level, Z_DEFLATED, windowBits, 8, Z_DEFAULT_STRATEGY) == Z_OK;
+        }
+
+        ~Stream() {
+            if (ok) deflateEnd(&z);
+        }
+
+        Stream(const Stream&) = delete;
+        Stream& operator=(const Stream&) = delete;
+
+        bool valid() const { return ok; }
+        bool reset() { return ok && deflateReset(&z) == Z_OK; }
+
+        template <typename String>
+        bool write(std::string_view input, String& out, bool finish = false) {
+            static constexpr size_t CHUNK = 16 * 1024;
+            z.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(input.data()));
+            z.avail_in = input.size();
+            while (true) {
+                size_t used = out.size();
+                out.resize(used + CHUNK);
+                z.next_out = reinterpret_cast<Bytef*>(&out[used]);
+                z.avail_out = CHUNK;
+                int rc = deflate(&z, finish ? Z_FINISH : Z_NO_FLUSH);
+                out.resize(used + CHUNK - z.avail_out);
+                if (rc == Z_STREAM_ERROR) return false;
+                if (finish) {
+                    if (rc == Z_STREAM_END) return true;
+                    continue;
+                }
+                if (z.avail_out != 0) return true; // all input consumed
+            }
+        }
+
+        template <typename String>
+        bool finish(String& out) { return write(std::string_view(), out, true); }
+
+    private:
+        friend class Compression;
+        z_stream z;
+        bool ok;
+    };
+
+private:
+    static Stream* threadStream(ContentCoding coding, int level) {
+        static thread_local std::unordered_map<int, std::unique_ptr<Stream>> streams;
+        auto& stream = streams[(int)coding * 16 + level];
+        if (!stream) stream = std::make_unique<Stream>(coding, level);
+        return stream->valid() ? stream.get() : nullptr;
+    }
+
+    static std::string_view trim(std::string_view value) {
+        while (!value.empty() && (value.front() == ' ' || value.front() == '\t')) value.remove_prefix(1);
+        while (!value.empty() && (value.back() == ' ' || value.back() == '\t')) value.remove_suffix(1);
+        return value;
+    }
+
+    static bool equalsIgnoreCase(std::string_view a, std::string_view b) {
+        if (a.size() != b.size()) return false;
+        for (size_t i = 0; i < a.size(); i++) {
+            if (std::tolower((unsigned char)a[i]) != std::tolower((unsigned char)b[i])) return false;
+        }
+        return true;
+    }
+};
+
+#endif // COMPRESSION_H
@@ -0,0 +1,82 @@
+#ifndef CONDITIONAL_H
+#define CONDITIONAL_H
+
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
+#include <string>
+#include <string_view>
+#include <sys/stat.h>
+#include "http-parser.h"
+
+// Validators and precondition checks for conditional GET (RFC 9110 section 13)
+class ConditionalRequest {
+public:
+    // Strong validator derived from a file's identity: inode, size and mtime in nanoseconds
+    static std::string fileETag(const struct stat& st, std::string_view suffix = "") {
+        char buffer[96];
+        snprintf(buffer, sizeof(buffer), "\"%llx-%llx-%llx",
+                 (unsigned long long)st.st_ino, (unsigned long long)st.st_size,
+                 (unsigned long long)st.st_mtim.tv_sec * 1000000000ULL + st.st_mtim.tv_nsec);
+        std::string etag(buffer);
+        if (!suffix.empty()) {
+            etag += "-";
+            etag += suffix;
+        }
+        return etag + "\"";
+    }
+
+    static std::string httpDate(time_t when) {
+        char buffer[64];
+        struct tm parts;
+        gmtime_r(&when, &parts);
+        strftime(buffer, sizeof(buffer), "%a, %d %b %Y %H:%M:%S GMT", &parts);
+        return buffer;
+    }
+
+    // True when a GET can be answered with 304: If-None-Match is checked with weak
+    // comparison and, only when absent, If-Modified-Since against lastModified.
+    static bool notModified(const HttpRequest& request, std::string_view etag, time_t lastModified = 0) {
+        if (request.method != "GET" && request.method != "HEAD") return false;
+
+        std::string_view ifNoneMatch = request.header("If-None-Match");
+        if (!ifNoneMatch.empty()) return etagListMatches(ifNoneMatch, etag);
+
+        std::string_view ifModifiedSince = request.header("If-Modified-Since");
+        if (ifModifiedSince.empty() || lastModified == 0) return false;
+        time_t since;
+        return parseHttpDate(ifModifiedSince, since) && lastModified <= since;
+    }
+
+    // IMF-fixdate, as sent by httpDate()
+    static bool parseHttpDate(std::string_view value, time_t& result) {
+        std::string text(value);
+        struct tm parts{};
+        const char* end = strptime(text.c_str(), "%a, %d %b %Y %H:%M:%S GMT", &parts);
+        if (!end) return false;
+        result = timegm(&parts);
+        return result != (time_t)-1;
+    }
+
+private:
+    static std::string_view opaqueTag(std::string_view etag) {
+        if (etag.substr(0, 2) == "W/") etag.remove_prefix(2);
+        return etag;
+    }
+
+    static bool etagListMatches(std::string_view list, std::string_view etag) {
+        std::string_view target = opaqueTag(etag);
+        while (!list.empty()) {
+            size_t comma = list.find(',');
+            std::string_view item = list.substr(0, comma);
+            while (!item.empty() && (item.front() == ' ' || item.front() == '\t')) item.remove_prefix(1);
+            while (!item.empty() && (item.back() == ' ' || item.back() == '\t')) item.remove_suffix(1);
+            if (item == "*" || opaqueTag(item) == target) return true;
+            if (comma == std::string_view::npos) break;
+            list.remove_prefix(comma + 1);
+        }
+        return false;
+    }
+};
+
+#endif // CONDITIONAL_H
@@ -0,0 +1,574 @@
+#ifndef COROUTINE_IO_H
+#define COROUTINE_IO_H
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <coroutine>
+#include <exception>
+#include <fcntl.h>
+#include <iostream>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <type_traits>
+#include <unistd.h>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+#include "event-loop.h"
+#include "send-queue.h"
+#include "thread-pool.h"
+#include "timer-wheel.h"
+
+// C++20 coroutines on top of EventLoop, so a handler reads as straight-line blocking
+// code while one thread multiplexes every connection it owns:
+//
+//     Task<void> serve(AsyncConnection& conn) {
+//         while (co_await conn.read() > 0) { ...parse conn.input(), fill conn.output()...
+//             if (!co_await conn.flush()) co_return; }
+//     }
+//
+// Socket operations try the syscall first and only suspend on EAGAIN; the loop resumes
+// them from the next readiness event. File operations (regular files are always
+// "ready" to epoll) run on a blocking pool and resume on the loop thread afterwards.
+
+class AsyncLoop;
+
+template <typename T = void>
+class Task;
+
+namespace coroutine_detail {
+
+// State shared by every Task promise: who to resume when done, and the loop that owns
+// the frame when the task was spawned rather than awaited
+struct PromiseBase {
+    std::coroutine_handle<> continuation;
+    std::exception_ptr error;
+    AsyncLoop* owner = nullptr;
+
+    std::suspend_always initial_suspend() noexcept { return {}; }
+    void unhandled_exception() { error = std::current_exception(); }
+};
+
+void finishSpawned(AsyncLoop* loop, std::coroutine_handle<> handle, std::exception_ptr error);
+
+struct FinalAwaiter {
+    bool await_ready() noexcept { return false; }
+
+    template <typename Promise>
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+        PromiseBase& promise = handle.promise();
+        if (promise.continuation) return promise.continuation;
+        if (promise.owner) finishSpawned(promise.owner, handle, promise.error); // destroys the frame
+        return std::noop_coroutine();
+    }
+
+    void await_resume() noexcept {}
+};
+
+template <typename T>
+struct ResultSlot {
+    std::optional<T> value;
+
+    template <typename U>
+    void return_value(U&& result) { value.emplace(std::forward<U>(result)); }
+    T take() { return std::move(*value); }
+};
+
+template <>
+struct ResultSlot<void> {
+    void return_void() {}
+    void take() {}
+};
+
+} // namespace coroutine_detail
+
+// Lazily started coroutine: the body runs when the Task is co_awaited (or spawned on an
+// AsyncLoop) and resumes its awaiter on completion. Exceptions propagate to the awaiter.
+template <typename T>
+class [[nodiscard]] Task {
+public:
+    struct promise_type : coroutine_detail::PromiseBase, coroutine_detail::ResultSlot<T> {
+        Task get_return_object() { return Task(std::coroutine_handle<promise_type>::from_promise(*this)); }
+        coroutine_detail::FinalAwaiter final_suspend() noexcept { return {}; }
+    };
+
+    Task(Task&& other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+    Task& operator=(Task&& other) noexcept {
+        if (this != &other) {
+            if (handle) handle.destroy();
+            handle = std::exchange(other.handle, nullptr);
+        }
+        return *this;
+    }
+    ~Task() {
+        if (handle) handle.destroy();
+    }
+
+    bool await_ready() const noexcept { return !handle || handle.done(); }
+
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+        handle.promise().continuation = awaiting;
+        return handle; // symmetric transfer: start the body without growing the stack
+    }
+
+    T await_resume() {
+        if (handle.promise().error) std::rethrow_exception(handle.promise().error);
+        return handle.promise().take();
+    }
+
+private:
+    friend class AsyncLoop;
+    explicit Task(std::coroutine_handle<promise_type> handle) : handle(handle) {}
+
+    std::coroutine_handle<promise_type> handle;
+};
+
+// Per-thread coroutine scheduler: an EventLoop for socket readiness, a TimerWheel for
+// operation deadlines, and a queue through which other threads hand coroutines back.
+// Tasks spawned on the loop are owned by it; any still suspended when it is destroyed
+// are destroyed with it, releasing their sockets.
+class AsyncLoop : private EventLoop::Handler {
+public:
+    // Offloaded file operations run on `blockingPool`; without one they run inline
+    explicit AsyncLoop(WorkStealingPool* blockingPool = nullptr)
+        : blockingPool(blockingPool), readyFd(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)) {
+        registered = events.valid() && readyFd >= 0 && events.add(readyFd, EPOLLIN | EPOLLET, this);
+    }
+
+    ~AsyncLoop() override {
+        // Destroying a top-level frame destroys the Tasks it was awaiting along with it
+        while (!spawned.empty()) {
+            auto handle = std::coroutine_handle<>::from_address(*spawned.begin());
+            spawned.erase(spawned.begin());
+            handle.destroy();
+        }
+        if (readyFd >= 0) close(readyFd);
+    }
+
+    AsyncLoop(const AsyncLoop&) = delete;
+    AsyncLoop& operator=(const AsyncLoop&) = delete;
+
+    bool valid() const { return registered; }
+    EventLoop& eventLoop() { return events; }
+    TimerWheel& timers() { return deadlines; }
+    size_t activeTasks() const { return active.load(std::memory_order_relaxed); }
+
+    // Start `task` now; the loop owns it until it finishes. Loop thread only.
+    void spawn(Task<void> task) {
+        std::coroutine_handle<> handle = task.handle;
+        task.handle.promise().owner = this;
+        task.handle = nullptr;
+        spawned.insert(handle.address());
+        active.fetch_add(1, std::memory_order_relaxed);
+        handle.resume();
+    }
+
+    // Dispatch until stop() is called from any thread
+    void run() {
+        events.run((int)deadlines.tick().count(), [this]() { deadlines.advance(); });
+    }
+
+    void stop() { events.stop(); }
+
+    // Resume `handle` on the loop thread; callable from any thread while the loop exists
+    void post(std::coroutine_handle<> handle) {
+        {
+            std::lock_guard<std::mutex> lock(readyMutex);
+            ready.push_back(handle);
+        }
+        uint64_t one = 1;
+        ssize_t ignored = write(readyFd, &one, sizeof(one));
+        (void)ignored;
+    }
+
+    // co_await loop.yield(): continue after the events that are already pending
+    auto yield() {
+        struct Yield {
+            AsyncLoop& loop;
+            bool await_ready() const noexcept { return false; }
+            void await_suspend(std::coroutine_handle<> awaiting) { loop.post(awaiting); }
+            void await_resume() const noexcept {}
+        };
+        return Yield{*this};
+    }
+
+    // co_await loop.offload(fn): run fn() on the blocking pool and resume with its result
+    // on the loop thread. errno set by fn is carried back along with the result.
+    template <typename Fn>
+    class Offload {
+    public:
+        using Result = std::invoke_result_t<Fn&>;
+        static_assert(!std::is_void_v<Result>, "offloaded calls must return a value");
+
+        Offload(AsyncLoop& loop, Fn fn) : loop(loop), fn(std::move(fn)) {}
+
+        bool await_ready() const noexcept { return loop.blockingPool == nullptr; }
+
+        void await_suspend(std::coroutine_handle<> awaiting) {
+            loop.blockingPool->submit([this, awaiting]() {
+                try {
+                    result.emplace(fn());
+                    savedErrno = errno;
+                } catch (...) {
+                    error = std::current_exception();
+                }
+                loop.post(awaiting);
+            });
+        }
+
+        Result await_resume() {
+            if (error) std::rethrow_exception(error);
+            if (!result) return fn(); // no pool: ran inline
+            errno = savedErrno;
+            return std::move(*result);
+        }
+
+    private:
+        AsyncLoop& loop;
+        Fn fn;
+        std::optional<Result> result;
+        std::exception_ptr error;
+        int savedErrno = 0;
+    };
+
+    template <typename Fn>
+    Offload<Fn> offload(Fn fn) { return Offload<Fn>(*this, std::move(fn)); }
+
+private:
+    friend void coroutine_detail::finishSpawned(AsyncLoop*, std::coroutine_handle<>, std::exception_ptr);
+
+    EventLoop events;
+    TimerWheel deadlines; // declared before anything whose timers it holds
+    WorkStealingPool* blockingPool;
+    int readyFd;
+    bool registered = false;
+    std::mutex readyMutex;
+    std::vector<std::coroutine_handle<>> ready;
+    std::vector<std::coroutine_handle<>> resuming;
+    std::unordered_set<void*> spawned;
+    std::atomic<size_t> active{0};
+
+    void onEvents(uint32_t) override {
+        uint64_t value;
+        while (read(readyFd, &value, sizeof(value)) > 0) {}
+        {
+            std::lock_guard<std::mutex> lock(readyMutex);
+            resuming.swap(ready);
+        }
+        for (std::coroutine_handle<> handle : resuming) handle.resume();
+        resuming.clear();
+    }
+};
+
+inline void coroutine_detail::finishSpawned(AsyncLoop* loop, std::coroutine_handle<> handle,
+                                            std::exception_ptr error) {
+    if (error) {
+        try {
+            std::rethrow_exception(error);
+        } catch (const std::exception& e) {
+            std::cerr << "Coroutine failed: " << e.what() << std::endl;
+        } catch (...) {
+            std::cerr << "Coroutine failed" << std::endl;
+        }
+    }
+    loop->spawned.erase(handle.address());
+    loop->active.fetch_sub(1, std::memory_order_relaxed);
+    handle.destroy();
+}
+
+// A non-blocking socket registered edge-triggered with an AsyncLoop. At most one
+// operation is outstanding at a time; it is retried on every readiness event until it
+// completes, or fails with ETIMEDOUT once its deadline passes without progress.
+class AsyncSocket : private EventLoop::Handler {
+public:
+    AsyncSocket(AsyncLoop& loop, int fd, bool ownsFd)
+        : loop(loop), socket(fd), ownsFd(ownsFd), deadline(*this) {
+        registered = EventLoop::setNonBlocking(fd) &&
+                     loop.eventLoop().add(fd, EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET, this);
+    }
+
+    ~AsyncSocket() override {
+        deadline.cancel();
+        if (registered) loop.eventLoop().remove(socket, this);
+        if (ownsFd) close(socket);
+    }
+
+    AsyncSocket(const AsyncSocket&) = delete;
+    AsyncSocket& operator=(const AsyncSocket&) = delete;
+
+    bool valid() const { return registered; }
+    int fd() const { return socket; }
+    AsyncLoop& asyncLoop() const { return loop; }
+
+protected:
+    // One suspended operation. attempt() performs the syscall and returns false while it
+    // would block; once it returns true the result is stored in the derived awaiter.
+    class Operation {
+    public:
+        explicit Operation(AsyncSocket& owner, std::chrono::milliseconds timeout)
+            : owner(owner), timeout(timeout) {}
+        virtual ~Operation() = default;
+
+        bool await_ready() { return attempt(); }
+
+        void await_suspend(std::coroutine_handle<> awaiting) {
+            waiter = awaiting;
+            owner.pending = this;
+            if (timeout.count() > 0) owner.loop.timers().schedule(owner.deadline, timeout);
+        }
+
+    protected:
+        virtual bool attempt() = 0;
+
+        AsyncSocket& owner;
+        bool timedOut = false;
+
+    private:
+        friend class AsyncSocket;
+        std::chrono::milliseconds timeout;
+        std::coroutine_handle<> waiter;
+    };
+
+    AsyncLoop& loop;
+
+private:
+    class Deadline : public TimerWheel::Timer {
+    public:
+        explicit Deadline(AsyncSocket& owner) : owner(owner) {}
+
+    protected:
+        void onTimeout() override { owner.expire(); }
+
+    private:
+        AsyncSocket& owner;
+    };
+
+    int socket;
+    bool ownsFd;
+    bool registered = false;
+    Operation* pending = nullptr;
+    Deadline deadline;
+
+    // Resuming may finish the coroutine that owns this socket, so nothing here touches
+    // `this` after resume()
+    void onEvents(uint32_t) override {
+        if (!pending) return;
+        if (!pending->attempt()) {
+            // Progress without completion (a partial write) restarts the deadline
+            if (pending->timeout.count() > 0) loop.timers().schedule(deadline, pending->timeout);
+            return;
+        }
+        resumePending();
+    }
+
+    void expire() {
+        if (!pending) return;
+        pending->timedOut = true;
+        resumePending();
+    }
+
+    void resumePending() {
+        deadline.cancel();
+        std::coroutine_handle<> waiter = pending->waiter;
+        pending = nullptr;
+        waiter.resume();
+    }
+};
+
+// One accepted client connection. read() appends to input(); write() drains a SendQueue,
+// flush() the connection's own output() queue.
+class AsyncConnection : public AsyncSocket {
+public:
+    static constexpr size_t READ_CHUNK = 16 * 1024;
+
+    // Takes ownership of `fd`
+    AsyncConnection(AsyncLoop& loop, int fd) : AsyncSocket(loop, fd, true) {}
+
+    std::string& input() { return inputBuffer; }
+    SendQueue& output() { return outputQueue; }
+
+    // co_await conn.read(): bytes appended to input(); 0 once the peer closed, -1 on error
+    // or when nothing arrived within `timeout` (errno ETIMEDOUT)
+    class ReadAwaiter : public Operation {
+    public:
+        ReadAwaiter(AsyncConnection& conn, size_t maxBytes, std::chrono::milliseconds timeout)
+            : Operation(conn, timeout), conn(conn), maxBytes(maxBytes) {}
+
+        ssize_t await_resume() {
+            if (timedOut) {
+                errno = ETIMEDOUT;
+                return -1;
+            }
+            return result;
+        }
+
+    protected:
+        bool attempt() override {
+            char chunk[READ_CHUNK];
+            ssize_t n = recv(conn.fd(), chunk, std::min(maxBytes, sizeof(chunk)), 0);
+            if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return false;
+            if (n < 0 && errno == EINTR) return attempt();
+            if (n > 0) conn.inputBuffer.append(chunk, n);
+            result = n;
+            return true;
+        }
+
+    private:
+        AsyncConnection& conn;
+        size_t maxBytes;
+        ssize_t result = -1;
+    };
+
+    // co_await conn.write(queue): true once everything queued went out. On error, or when
+    // the peer accepted nothing for `timeout`, the rest is dropped and the result is false.
+    class WriteAwaiter : public Operation {
+    public:
+        WriteAwaiter(AsyncConnection& conn, SendQueue& queue, std::chrono::milliseconds timeout)
+            : Operation(conn, timeout), conn(conn), queue(queue) {}
+
+        bool await_resume() {
+            if (timedOut) queue.clear();
+            return ok && !timedOut;
+        }
+
+    protected:
+        bool attempt() override {
+            SendQueue::Result status = queue.writeTo(conn.fd());
+            if (status == SendQueue::Result::WouldBlock) return false;
+            ok = status == SendQueue::Result::Done;
+            if (!ok) queue.clear();
+            return true;
+        }
+
+    private:
+        AsyncConnection& conn;
+        SendQueue& queue;
+        bool ok = false;
+    };
+
+    ReadAwaiter read(std::chrono::milliseconds timeout = std::chrono::milliseconds(0),
+                     size_t maxBytes = READ_CHUNK) {
+        return ReadAwaiter(*this, maxBytes, timeout);
+    }
+
+    WriteAwaiter write(SendQueue& queue, std::chrono::milliseconds timeout = std::chrono::seconds(30)) {
+        return WriteAwaiter(*this, queue, timeout);
+    }
+
+    WriteAwaiter flush(std::chrono::milliseconds timeout = std::chrono::seconds(30)) {
+        return write(outputQueue, timeout);
+    }
+
+private:
+    std::string inputBuffer;
+    SendQueue outputQueue;
+};
+
+// A listening socket; co_await listener.accept() yields a non-blocking client fd, or -1
+// once the socket is closed or fails. The caller keeps ownership of the listening fd.
+class AsyncListener : public AsyncSocket {
+public:
+    AsyncListener(AsyncLoop& loop, int fd) : AsyncSocket(loop, fd, false) {}
+
+    class AcceptAwaiter : public Operation {
+    public:
+        explicit AcceptAwaiter(AsyncListener& listener) : Operation(listener, std::chrono::milliseconds(0)) {}
+
+        int await_resume() { return result; }
+
+    protected:
+        bool attempt() override {
+            while (true) {
+                result = accept4(owner.fd(), nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+                if (result >= 0) return true;
+                if (errno == EAGAIN || errno == EWOULDBLOCK) return false;
+                // The client gave up while queued: take the next one
+                if (errno != EINTR && errno != ECONNABORTED) return true;
+            }
+        }
+
+    private:
+        int result = -1;
+    };
+
+    AcceptAwaiter accept() { return AcceptAwaiter(*this); }
+};
+
+// A regular file whose blocking calls run on the loop's blocking pool:
+//
+//     AsyncFile file(loop);
+//     if (co_await file.open(path, O_RDONLY) < 0) ...
+//     ssize_t n = co_await file.read(buffer, file.size(), 0);
+class AsyncFile {
+public:
+    explicit AsyncFile(AsyncLoop& loop) : loop(loop) {}
+    ~AsyncFile() {
+        if (descriptor >= 0) close(descriptor);
+    }
+
+    AsyncFile(const AsyncFile&) = delete;
+    AsyncFile& operator=(const AsyncFile&) = delete;
+
+    int fd() const { return descriptor; }
+    const struct stat& status() const { return info; }
+    size_t size() const { return (size_t)info.st_size; }
+
+    // Give up the descriptor, e.g. to SendQueue::appendFile
+    int release() { return std::exchange(descriptor, -1); }
+
+    // Open and fstat `path`; the descriptor, or -1 with errno set
+    auto open(const std::string& path, int flags, mode_t mode = 0644) {
+        return loop.offload([this, &path, flags, mode]() {
+            if (descriptor >= 0) close(descriptor);
+            descriptor = ::open(path.c_str(), flags | O_CLOEXEC, mode);
+            if (descriptor >= 0 && fstat(descriptor, &info) != 0) {
+                int saved = errno;
+                close(descriptor);
+                descriptor = -1;
+                errno = saved;
+            }
+            return descriptor;
+        });
+    }
+
+    // Read up to `length` bytes at `offset`; short only at end of file
+    auto read(char* buffer, size_t length, off_t offset) {
+        return loop.offload([this, buffer, length, offset]() {
+            size_t done = 0;
+            while (done < length) {
+                ssize_t n = pread(descriptor, buffer + done, length - done, offset + done);
+                if (n < 0 && errno == EINTR) continue;
+                if (n < 0) return (ssize_t)-1;
+                if (n == 0) break;
+                done += n;
+            }
+            return (ssize_t)done;
+        });
+    }
+
+    // Write all `length` bytes at `offset`; the count written, or -1
+    auto write(const char* buffer, size_t length, off_t offset) {
+        return loop.offload([this, buffer, length, offset]() {
+            size_t done = 0;
+            while (done < length) {
+                ssize_t n = pwrite(descriptor, buffer + done, length - done, offset + done);
+                if (n < 0 && errno == EINTR) continue;
+                if (n < 0) return (ssize_t)-1;
+                done += n;
+            }
+            return (ssize_t)done;
+        });
+    }
+
+private:
+    AsyncLoop& loop;
+    int descriptor = -1;
+    struct stat info {};
+};
+
+#endif // COROUTINE_IO_H
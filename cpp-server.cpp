@@ -11,6 +11,18 @@
 #include <iomanip>
 #include <filesystem>
 #include <algorithm>
+#include <cstring>
+#include <memory>
+#include "thread-pool.h"
+#include "coroutine-io.h"
+#include "http-parser.h"
+#include "listener.h"
+#include "send-queue.h"
+#include "response-writer.h"
+#include "conditional.h"
+#include "byte-range.h"
+#include "caesar-cipher.h"
+#include "json-stream.h"
 
 // Socket includes for cross-platform compatibility
 #ifdef _WIN32
@@ -25,6 +37,9 @@
     #include <arpa/inet.h>
     #include <unistd.h>
     #include <netdb.h>
+    #include <fcntl.h>
+    #include <signal.h>
+    #include <sys/stat.h>
     #define SOCKET_ERROR_CODE errno
     #define CLOSE_SOCKET close
     #define INVALID_SOCKET -1
@@ -33,11 +48,102 @@
 
 namespace fs = std::filesystem;
 
+// Body of the request being handled, decoded as it arrives instead of being buffered
+// whole. The first read drops the request head from the connection buffer, so handlers
+// copy what they need out of the HttpRequest before reading.
+class RequestBody {
+public:
+    RequestBody(AsyncConnection& conn, const HttpRequest& request, size_t headBytes, size_t maxBytes,
+                std::chrono::milliseconds timeout)
+        : conn(conn), reader(request.contentLength, request.chunked, maxBytes), headBytes(headBytes),
+          expectContinue(request.headerHasToken("Expect", "100-continue")), timeout(timeout) {}
+
+    bool done() const { return reader.done(); }
+    size_t bytesRead() const { return reader.bodyBytes(); }
+
+    // Status for a failed read(): 400 or 413 for a malformed or oversized body, 408 when
+    // the client stopped sending
+    int errorCode() const { return reader.failed() ? reader.errorCode() : 408; }
+
+    // Append the next decoded piece, at most maxBytes, to `out`; false if the body is
+    // malformed or too large, or the client stopped sending
+    Task<bool> read(std::string& out, size_t maxBytes) {
+        dropHead();
+        size_t before = out.size();
+        while (true) {
+            HttpBodyReader::Status status = reader.read(conn.input(), out, maxBytes);
+            if (status == HttpBodyReader::Status::Error) co_return false;
+            if (status == HttpBodyReader::Status::Complete || out.size() > before) co_return true;
+            if (expectContinue) {
+                // The client holds the body back until told to go ahead
+                expectContinue = false;
+                conn.output().append("HTTP/1.1 100 Continue\r\n\r\n");
+                if (!co_await conn.flush()) co_return false;
+            }
+            if (co_await conn.read(timeout) <= 0) co_return false;
+        }
+    }
+
+    // Discard whatever the handler left unread so the next pipelined request lines up;
+    // false when more than maxBytes remain and the connection should be closed instead
+    Task<bool> skip(size_t maxBytes) {
+        dropHead();
+        if (reader.done()) co_return true;
+        size_t remaining = reader.remainingBytes();
+        if (expectContinue || (remaining != SIZE_MAX && remaining > maxBytes)) co_return false;
+        std::string discarded;
+        size_t skipped = 0;
+        while (!reader.done()) {
+            discarded.clear();
+            if (!co_await read(discarded, AsyncConnection::READ_CHUNK)) co_return false;
+            skipped += discarded.size();
+            if (skipped > maxBytes) co_return false;
+        }
+        co_return true;
+    }
+
+private:
+    AsyncConnection& conn;
+    HttpBodyReader reader;
+    size_t headBytes;
+    bool expectContinue;
+    std::chrono::milliseconds timeout;
+
+    void dropHead() {
+        if (headBytes == 0) return;
+        conn.input().erase(0, headBytes);
+        headBytes = 0;
+    }
+};
+
 class CPPHTTPServer {
 private:
     int port;
     std::atomic<bool> running;
     std::string rootDir;
+    size_t workerThreads;
+    // Blocking file and directory calls made by the coroutine handlers
+    std::unique_ptr<WorkStealingPool> workerPool;
+
+    // SO_REUSEPORT listening sockets, each drained by its own event loop thread
+    int listenerCount;
+    int backlog;
+    bool pinCpus;
+    std::vector<int> listenSockets;
+    std::vector<std::unique_ptr<AcceptStats>> acceptStats;
+    std::vector<std::unique_ptr<AsyncLoop>> loops;
+    time_t startTime;
+
+    // Persistent connection limits
+    static constexpr int KEEP_ALIVE_TIMEOUT = 5;
+    static constexpr int KEEP_ALIVE_REQUESTS = 100;
+    // Request bodies are streamed, never buffered whole
+    static constexpr int BODY_TIMEOUT = 30;                              // seconds without body bytes
+    static constexpr size_t MAX_UPLOAD_SIZE = 1024ull * 1024 * 1024;     // /api/save bodies, else 413
+    static constexpr size_t MAX_DISCARDED_BODY = 8 * 1024 * 1024;        // unread body skipped to keep a connection
+    static constexpr size_t SAVE_CHUNK = 64 * 1024;                      // /api/save content per file write
+    static constexpr size_t MAX_FILENAME = 1024;
+    std::atomic<uint64_t> uploadCounter{0};
 
     #ifdef _WIN32
     SOCKET serverSocket;
@@ -45,73 +151,29 @@ private:
     int serverSocket;
     #endif
 
-    // Caesar cipher encryption/decryption methods
-    std::string caesarEncrypt(const std::string& text, int shift = 6) {
-        std::string result;
-        for (char c : text) {
-            if (isalpha(c)) {
-                char base = islower(c) ? 'a' : 'A';
-                c = (c - base + shift) % 26 + base;
-            } else if (isdigit(c)) {
-                // Handle negative modulo for digits
-                int digit = c - '0';
-                digit = (digit + shift) % 10;
-                if (digit < 0) digit += 10;
-                c = '0' + digit;
-            }
-            // Leave other characters unchanged
-            result += c;
-        }
-        return result;
-    }
-
-    std::string caesarDecrypt(const std::string& text, int shift = 6) {
-        std::string result;
-        for (char c : text) {
-            if (isalpha(c)) {
-                char base = islower(c) ? 'a' : 'A';
-                c = (c - base - shift + 26) % 26 + base;
-            } else if (isdigit(c)) {
-                // Handle negative modulo for digits
-                int digit = c - '0';
-                digit = (digit - shift) % 10;
-                if (digit < 0) digit += 10;
-                c = '0' + digit;
-            }
-            // Leave other characters unchanged
-            result += c;
-        }
-        return result;
-    }
-
-    // File operations with encryption
-    std::string readEncryptedFile(const std::string& filename) {
-        std::ifstream file(filename, std::ios::binary);
-        if (!file) return "";
+    // Encrypted file reads; the blocking calls run on the worker pool
+    Task<std::string> readEncryptedFile(AsyncLoop& loop, const std::string& filename) {
+        AsyncFile file(loop);
+        if (co_await file.open(filename, O_RDONLY) < 0) co_return "";
 
-        std::string content((std::istreambuf_iterator<char>(file)),
-                           std::istreambuf_iterator<char>());
+        std::string content(file.size(), '\0');
+        ssize_t bytesRead = co_await file.read(&content[0], content.size(), 0);
+        content.resize(bytesRead > 0 ? bytesRead : 0);
 
         // Auto-detect if content is encrypted (look for common patterns)
         if (content.size() > 10 && content.find(' ') == std::string::npos) {
             // Likely encrypted, decrypt it
-            return caesarDecrypt(content);
+            co_return CaesarCipher::decrypt(content);
         }
-        return content;
-    }
-
-    bool writeEncryptedFile(const std::string& filename, const std::string& content) {
-        std::ofstream file(filename, std::ios::binary);
-        if (!file) return false;
-
-        std::string encrypted = caesarEncrypt(content);
-        file.write(encrypted.c_str(), encrypted.size());
-        return true;
+        co_return content;
     }
 
 public:
-    CPPHTTPServer(int port = 8000, const std::string& rootDir = ".")
-        : port(port), running(false), rootDir(rootDir), serverSocket(INVALID_SOCKET) {}
+    CPPHTTPServer(int port = 8000, const std::string& rootDir = ".", size_t workerThreads = 0,
+                  int listenerCount = 1, int backlog = SOMAXCONN, bool pinCpus = false)
+        : port(port), running(false), rootDir(rootDir), workerThreads(workerThreads),
+          listenerCount(std::max(1, listenerCount)), backlog(backlog), pinCpus(pinCpus),
+          startTime(time(nullptr)), serverSocket(INVALID_SOCKET) {}
 
     ~CPPHTTPServer() {
         stop();
@@ -124,146 +186,216 @@ public:
             std::cerr << "WSAStartup failed" << std::endl;
             return false;
         }
-        #endif
-
-        serverSocket = socket(AF_INET, SOCK_STREAM, 0);
-        if (serverSocket == INVALID_SOCKET) {
-            std::cerr << "Socket creation failed: " << SOCKET_ERROR_CODE << std::endl;
-            return false;
-        }
-
-        // Set socket options
-        int opt = 1;
-        #ifdef _WIN32
-        setsockopt(serverSocket, SOL_SOCKET, SO_REUSEADDR, (char*)&opt, sizeof(opt));
         #else
-        setsockopt(serverSocket, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+        // A client hanging up mid-sendfile must not kill the server
+        signal(SIGPIPE, SIG_IGN);
         #endif
 
-        sockaddr_in serverAddr;
-        serverAddr.sin_family = AF_INET;
-        serverAddr.sin_addr.s_addr = INADDR_ANY;
-        serverAddr.sin_port = htons(port);
-
-        if (bind(serverSocket, (sockaddr*)&serverAddr, sizeof(serverAddr)) == SOCKET_ERROR) {
-            std::cerr << "Bind failed: " << SOCKET_ERROR_CODE << std::endl;
-            CLOSE_SOCKET(serverSocket);
-            return false;
+        for (int i = 0; i < listenerCount; i++) {
+            int fd = Listener::open(port, backlog, listenerCount > 1);
+            if (fd < 0) {
+                for (int open : listenSockets) CLOSE_SOCKET(open);
+                listenSockets.clear();
+                return false;
+            }
+            listenSockets.push_back(fd);
+            acceptStats.push_back(std::make_unique<AcceptStats>());
         }
-
-        if (listen(serverSocket, 10) == SOCKET_ERROR) {
-            std::cerr << "Listen failed: " << SOCKET_ERROR_CODE << std::endl;
-            CLOSE_SOCKET(serverSocket);
-            return false;
+        serverSocket = listenSockets[0];
+
+        workerPool = std::make_unique<WorkStealingPool>(workerThreads);
+        for (int i = 0; i < listenerCount; i++) {
+            loops.push_back(std::make_unique<AsyncLoop>(workerPool.get()));
+            if (!loops.back()->valid()) {
+                std::cerr << "Event loop setup failed: " << SOCKET_ERROR_CODE << std::endl;
+                return false;
+            }
         }
 
         running = true;
         std::cout << "🚀 C++ ASM Server started on port " << port << std::endl;
         std::cout << "📁 Serving from: " << fs::absolute(rootDir) << std::endl;
         std::cout << "🌐 Access: http://localhost:" << port << std::endl;
+        std::cout << "👂 Listeners: " << listenerCount << (listenerCount > 1 ? " (SO_REUSEPORT)" : "")
+                  << ", backlog " << backlog << std::endl;
         std::cout << "⏹️  Press Ctrl+C to stop" << std::endl;
 
         return true;
     }
 
     void run() {
-        while (running) {
-            sockaddr_in clientAddr;
-            #ifdef _WIN32
-            int clientAddrLen = sizeof(clientAddr);
-            #else
-            socklen_t clientAddrLen = sizeof(clientAddr);
-            #endif
-
-            #ifdef _WIN32
-            SOCKET clientSocket = accept(serverSocket, (sockaddr*)&clientAddr, &clientAddrLen);
-            #else
-            int clientSocket = accept(serverSocket, (sockaddr*)&clientAddr, &clientAddrLen);
-            #endif
+        std::cout << "🔁 Event loops: " << loops.size() << ", file worker pool: " << workerPool->size()
+                  << " threads" << std::endl;
+
+        // Loop 0 runs on this thread, the rest get their own threads
+        std::vector<std::thread> loopThreads;
+        for (int i = 1; i < listenerCount; i++) {
+            loopThreads.emplace_back([this, i]() { runLoop(i); });
+        }
+        runLoop(0);
+        for (auto& thread : loopThreads) {
+            thread.join();
+        }
+
+        // Finish in-flight file calls before the loops they resume on go away
+        workerPool->shutdown();
+        loops.clear();
+    }
 
+    void runLoop(int index) {
+        if (pinCpus) Listener::pinCurrentThread(index);
+        AsyncLoop& loop = *loops[index];
+        loop.spawn(acceptLoop(loop, index));
+        loop.run();
+    }
+
+    // Each client becomes a coroutine on the loop that accepted it
+    Task<void> acceptLoop(AsyncLoop& loop, int index) {
+        AsyncListener listener(loop, listenSockets[index]);
+        AcceptStats& stats = *acceptStats[index];
+
+        while (running) {
+            int clientSocket = co_await listener.accept();
             if (clientSocket == INVALID_SOCKET) {
-                if (running) {
-                    std::cerr << "Accept failed: " << SOCKET_ERROR_CODE << std::endl;
-                }
+                if (!running || errno == EBADF || errno == EINVAL) co_return; // listener closed
+                std::cerr << "Accept failed: " << SOCKET_ERROR_CODE << std::endl;
+                co_await loop.yield(); // e.g. out of descriptors: let open connections finish first
                 continue;
             }
-
-            // Handle client in a separate thread
-            std::thread([this, clientSocket]() {
-                handleClient(clientSocket);
-                CLOSE_SOCKET(clientSocket);
-            }).detach();
+            stats.record();
+            loop.spawn(handleClient(loop, clientSocket));
         }
     }
 
     void stop() {
         running = false;
-        if (serverSocket != INVALID_SOCKET) {
-            CLOSE_SOCKET(serverSocket);
-            serverSocket = INVALID_SOCKET;
+        for (auto& loop : loops) {
+            loop->stop();
+        }
+        for (int fd : listenSockets) {
+            shutdown(fd, SHUT_RDWR);
+            CLOSE_SOCKET(fd);
         }
+        listenSockets.clear();
+        serverSocket = INVALID_SOCKET;
         #ifdef _WIN32
         WSACleanup();
         #endif
     }
 
 private:
-    void handleClient(int clientSocket) {
-        char buffer[4096];
-        int bytesReceived = recv(clientSocket, buffer, sizeof(buffer) - 1, 0);
+    Task<void> handleClient(AsyncLoop& loop, int clientSocket) {
+        AsyncConnection conn(loop, clientSocket);
+        if (!conn.valid()) co_return;
+
+        // An idle persistent connection is dropped after the timeout
+        const std::chrono::seconds idleTimeout(KEEP_ALIVE_TIMEOUT);
+        std::string& buffer = conn.input();
+        HttpParser parser(64 * 1024);
+        int served = 0;
+        while (running) {
+            HttpParser::Status status = parser.parseHead(buffer);
+            if (status == HttpParser::Status::Error) {
+                sendError(conn, parser.errorCode(), HttpParser::errorReason(parser.errorCode()), false);
+                co_await conn.flush();
+                co_return;
+            }
 
-        if (bytesReceived <= 0) {
-            return;
-        }
+            if (status == HttpParser::Status::Incomplete) {
+                if (co_await conn.read(idleTimeout) <= 0) co_return; // closed, failed or idle past the timeout
+                continue;
+            }
 
-        buffer[bytesReceived] = '\0';
-        std::string request(buffer);
+            // Pipelined requests are answered one at a time, in arrival order
+            const HttpRequest& request = parser.request();
+            bool keepAlive = ++served < KEEP_ALIVE_REQUESTS && request.keepAlive;
+            RequestBody body(conn, request, parser.consumed(), MAX_UPLOAD_SIZE, std::chrono::seconds(BODY_TIMEOUT));
+            co_await handleRequest(conn, request, body, keepAlive);
+            if (!co_await conn.flush() || !keepAlive) co_return;
+            if (!co_await body.skip(MAX_DISCARDED_BODY)) co_return;
+            parser.reset();
+        }
+    }
 
-        // Parse HTTP request
-        std::string method, path, httpVersion;
-        std::istringstream requestStream(request);
-        requestStream >> method >> path >> httpVersion;
+    // Handlers queue their response on conn.output(); handleClient flushes it
+    Task<void> handleRequest(AsyncConnection& conn, const HttpRequest& request, RequestBody& body, bool keepAlive) {
+        std::string_view method = request.method;
+        std::string path(request.path);
 
         // Default to index.html if root path
         if (path == "/") {
             path = "/index.html";
         }
 
-        // Remove query parameters
-        size_t queryPos = path.find('?');
-        if (queryPos != std::string::npos) {
-            path = path.substr(0, queryPos);
-        }
-
         // Security: Prevent directory traversal
         if (path.find("..") != std::string::npos) {
-            sendError(clientSocket, 403, "Forbidden");
-            return;
+            sendError(conn, 403, "Forbidden", keepAlive);
+            co_return;
         }
 
         // Serve file or handle special routes
         if (method == "GET") {
             if (path == "/edit") {
-                serveEditor(clientSocket);
+                serveEditor(conn, keepAlive);
             } else if (path == "/api/files") {
-                listFiles(clientSocket);
+                co_await listFiles(conn, keepAlive);
+            } else if (path == "/api/stats") {
+                sendPoolStats(conn, keepAlive);
             } else {
-                serveFile(clientSocket, path);
+                co_await serveFile(conn, request, path, keepAlive);
             }
         } else if (method == "POST" && path == "/api/save") {
-            handleSave(clientSocket, request);
+            co_await handleSave(conn, body, keepAlive);
+        } else {
+            sendError(conn, 405, "Method Not Allowed", keepAlive);
+        }
+    }
+
+    static std::string_view connectionHeader(bool keepAlive) {
+        static const std::string keepAliveHeaders =
+            "Connection: keep-alive\r\nKeep-Alive: timeout=" + std::to_string(KEEP_ALIVE_TIMEOUT) +
+            ", max=" + std::to_string(KEEP_ALIVE_REQUESTS) + "\r\n";
+        if (!keepAlive) return "Connection: close\r\n";
+        return keepAliveHeaders;
+    }
+
+    // Head for a response whose body follows with conn.output().append*()
+    static void writeHead(AsyncConnection& conn, std::string_view status, std::string_view contentType,
+                          size_t contentLength, bool keepAlive, std::string_view extraHeaders = "") {
+        ResponseWriter(conn.output()).status(status)
+            .headers("Content-Type: ").headers(contentType).headers("; charset=utf-8\r\n")
+            .header("Content-Length", (uint64_t)contentLength)
+            .headers(extraHeaders).headers(connectionHeader(keepAlive)).end();
+    }
+
+    // Small bodies share the head's buffer; larger ones are handed over without a copy
+    static void sendBody(AsyncConnection& conn, std::string&& body) {
+        if (body.size() <= 4096) {
+            conn.output().append(std::string_view(body));
         } else {
-            sendError(clientSocket, 405, "Method Not Allowed");
+            conn.output().appendOwned(std::move(body));
         }
     }
 
-    void serveFile(int clientSocket, const std::string& path) {
+    Task<void> serveFile(AsyncConnection& conn, const HttpRequest& request, const std::string& path, bool keepAlive) {
         std::string fullPath = rootDir + path;
 
-        if (!fs::exists(fullPath)) {
-            sendError(clientSocket, 404, "Not Found");
-            return;
+        struct stat st;
+        if (co_await conn.asyncLoop().offload([&]() { return stat(fullPath.c_str(), &st); }) != 0) {
+            sendError(conn, 404, "Not Found", keepAlive);
+            co_return;
+        }
+
+        // Validators come from stat alone, so an unchanged file is never opened
+        std::string etag = ConditionalRequest::fileETag(st);
+        std::string validators = "ETag: " + etag + "\r\n"
+                                 "Last-Modified: " + ConditionalRequest::httpDate(st.st_mtim.tv_sec) + "\r\n";
+        if (ConditionalRequest::notModified(request, etag, st.st_mtim.tv_sec)) {
+            ResponseWriter(conn.output()).status("304 Not Modified").headers(validators)
+                .headers(connectionHeader(keepAlive)).end();
+            co_return;
         }
+        validators += "Accept-Ranges: bytes\r\n";
 
         // Determine content type
         std::string contentType = "text/plain";
@@ -278,25 +410,81 @@ private:
         else if (extension == ".gif") contentType = "image/gif";
         else if (extension == ".svg") contentType = "image/svg+xml";
 
+        // Binary assets can't carry Caesar-encrypted text, so they go out with sendfile
+        // instead of being read into memory
+        if (contentType.compare(0, 6, "image/") == 0 && extension != ".svg") {
+            co_await serveFileZeroCopy(conn, request, fullPath, contentType, etag, validators, keepAlive);
+            co_return;
+        }
+
         // Read file content with encryption support
-        std::string content = readEncryptedFile(fullPath);
+        std::string content = co_await readEncryptedFile(conn.asyncLoop(), fullPath);
         if (content.empty()) {
-            sendError(clientSocket, 500, "Internal Server Error");
-            return;
+            sendError(conn, 500, "Internal Server Error", keepAlive);
+            co_return;
+        }
+
+        // Ranges address the decrypted text, whose bytes follow from the file the ETag names
+        std::vector<ByteRange::Span> ranges;
+        switch (ByteRange::evaluate(request, content.size(), etag, st.st_mtim.tv_sec, ranges)) {
+        case ByteRange::Outcome::Unsatisfiable:
+            sendRangeNotSatisfiable(conn, content.size(), keepAlive);
+            co_return;
+        case ByteRange::Outcome::Partial: {
+            RangeResponse partial(std::move(ranges), contentType + "; charset=utf-8", content.size());
+            writePartialHead(conn, partial, validators, keepAlive);
+            partial.appendBufferBody(conn.output(), std::make_shared<const std::string>(std::move(content)));
+            co_return;
+        }
+        case ByteRange::Outcome::Full:
+            break;
         }
 
         // Send HTTP response
-        std::string response = "HTTP/1.1 200 OK\r\n"
-                             "Content-Type: " + contentType + "; charset=utf-8\r\n"
-                             "Content-Length: " + std::to_string(content.size()) + "\r\n"
-                             "Connection: close\r\n"
-                             "\r\n" + content;
+        writeHead(conn, "200 OK", contentType, content.size(), keepAlive, validators);
+        sendBody(conn, std::move(content));
+    }
+
+    Task<void> serveFileZeroCopy(AsyncConnection& conn, const HttpRequest& request, const std::string& fullPath,
+                                 const std::string& contentType, const std::string& etag,
+                                 const std::string& validators, bool keepAlive) {
+        AsyncFile file(conn.asyncLoop());
+        if (co_await file.open(fullPath, O_RDONLY) < 0 || !S_ISREG(file.status().st_mode) || file.size() == 0) {
+            sendError(conn, 500, "Internal Server Error", keepAlive);
+            co_return;
+        }
+
+        // Each range is its own sendfile segment, so partial bodies stay zero-copy too
+        std::vector<ByteRange::Span> ranges;
+        switch (ByteRange::evaluate(request, file.size(), etag, file.status().st_mtim.tv_sec, ranges)) {
+        case ByteRange::Outcome::Unsatisfiable:
+            sendRangeNotSatisfiable(conn, file.size(), keepAlive);
+            co_return;
+        case ByteRange::Outcome::Partial: {
+            RangeResponse partial(std::move(ranges), contentType, file.size());
+            SendQueue body;
+            if (!partial.appendFileBody(body, file.release())) {
+                sendError(conn, 500, "Internal Server Error", keepAlive);
+                co_return;
+            }
+            writePartialHead(conn, partial, validators, keepAlive);
+            conn.output().append(std::move(body));
+            co_return;
+        }
+        case ByteRange::Outcome::Full:
+            break;
+        }
 
-        send(clientSocket, response.c_str(), response.size(), 0);
+        SendQueue& output = conn.output();
+        ResponseWriter(output).status("200 OK").header("Content-Type", contentType)
+            .header("Content-Length", (uint64_t)file.size())
+            .headers(validators).headers(connectionHeader(keepAlive)).end();
+        size_t size = file.size();
+        output.appendFile(file.release(), 0, size);
     }
 
-    void serveEditor(int clientSocket) {
-        std::string editorHtml =
+    void serveEditor(AsyncConnection& conn, bool keepAlive) {
+        static constexpr std::string_view editorHtml =
             "<!DOCTYPE html>\n"
             "<html>\n"
             "<head>\n"
@@ -436,34 +624,33 @@ private:
             "</body>\n"
             "</html>";
 
-        std::string response = "HTTP/1.1 200 OK\r\n"
-                             "Content-Type: text/html; charset=utf-8\r\n"
-                             "Content-Length: " + std::to_string(editorHtml.size()) + "\r\n"
-                             "Connection: close\r\n"
-                             "\r\n" + editorHtml;
-
-        send(clientSocket, response.c_str(), response.size(), 0);
+        // The page is a constant, so it is sent straight from the binary's data
+        writeHead(conn, "200 OK", "text/html", editorHtml.size(), keepAlive);
+        conn.output().appendBorrowed(editorHtml);
     }
 
-    void listFiles(int clientSocket) {
-        std::vector<std::string> files;
-
-        try {
-            for (const auto& entry : fs::recursive_directory_iterator(rootDir)) {
-                if (entry.is_regular_file()) {
-                    std::string path = entry.path().string();
-                    // Convert to web path
-                    if (path.find(rootDir) == 0) {
-                        path = path.substr(rootDir.size());
-                        // Convert backslashes to forward slashes on Windows
-                        std::replace(path.begin(), path.end(), '\\', '/');
-                        files.push_back(path);
+    Task<void> listFiles(AsyncConnection& conn, bool keepAlive) {
+        // Walking the tree is blocking disk work, so it runs on the worker pool
+        std::vector<std::string> files = co_await conn.asyncLoop().offload([this]() {
+            std::vector<std::string> files;
+            try {
+                for (const auto& entry : fs::recursive_directory_iterator(rootDir)) {
+                    if (entry.is_regular_file()) {
+                        std::string path = entry.path().string();
+                        // Convert to web path
+                        if (path.find(rootDir) == 0) {
+                            path = path.substr(rootDir.size());
+                            // Convert backslashes to forward slashes on Windows
+                            std::replace(path.begin(), path.end(), '\\', '/');
+                            files.push_back(path);
+                        }
                     }
                 }
+            } catch (const std::exception& e) {
+                std::cerr << "Error listing files: " << e.what() << std::endl;
             }
-        } catch (const std::exception& e) {
-            std::cerr << "Error listing files: " << e.what() << std::endl;
-        }
+            return files;
+        });
 
         // Create JSON response
         std::string json = "[";
@@ -473,89 +660,212 @@ private:
         }
         json += "]";
 
-        std::string response = "HTTP/1.1 200 OK\r\n"
-                             "Content-Type: application/json; charset=utf-8\r\n"
-                             "Content-Length: " + std::to_string(json.size()) + "\r\n"
-                             "Connection: close\r\n"
-                             "\r\n" + json;
-
-        send(clientSocket, response.c_str(), response.size(), 0);
+        writeHead(conn, "200 OK", "application/json", json.size(), keepAlive);
+        sendBody(conn, std::move(json));
     }
 
-    void handleSave(int clientSocket, const std::string& request) {
-        // Extract JSON body
-        size_t bodyPos = request.find("\r\n\r\n");
-        if (bodyPos == std::string::npos) {
-            sendError(clientSocket, 400, "Bad Request");
-            return;
+    void sendPoolStats(AsyncConnection& conn, bool keepAlive) {
+        std::string depths;
+        for (size_t depth : workerPool->queueDepths()) {
+            if (!depths.empty()) depths += ",";
+            depths += std::to_string(depth);
         }
 
-        std::string body = request.substr(bodyPos + 4);
+        std::string json = "{\"workers\":" + std::to_string(workerPool->size()) +
+                           ",\"queue_depth\":" + std::to_string(workerPool->queueDepth()) +
+                           ",\"worker_queue_depths\":[" + depths + "]" +
+                           ",\"steals\":" + std::to_string(workerPool->stealCount()) +
+                           ",\"tasks_executed\":" + std::to_string(workerPool->executedCount());
+
+        // Client coroutines currently suspended or running on each loop
+        std::string connections;
+        for (const auto& loop : loops) {
+            if (!connections.empty()) connections += ",";
+            connections += std::to_string(loop->activeTasks() - 1); // minus the accept loop
+        }
+        json += ",\"event_loops\":" + std::to_string(loops.size()) +
+                ",\"loop_connections\":[" + connections + "]";
+
+        double uptime = difftime(time(nullptr), startTime);
+        std::string listeners;
+        for (size_t i = 0; i < acceptStats.size(); i++) {
+            if (!listeners.empty()) listeners += ",";
+            listeners += acceptStats[i]->toJson((int)i, uptime);
+        }
+        json += ",\"listen_backlog\":" + std::to_string(backlog) +
+                ",\"listeners\":[" + listeners + "]}";
 
-        // Simple JSON parsing (for demonstration)
-        size_t filenamePos = body.find("\"filename\":\"");
-        size_t contentPos = body.find("\"content\":\"");
+        writeHead(conn, "200 OK", "application/json", json.size(), keepAlive);
+        sendBody(conn, std::move(json));
+    }
 
-        if (filenamePos == std::string::npos || contentPos == std::string::npos) {
-            sendError(clientSocket, 400, "Invalid JSON");
-            return;
+    // Temp file an upload streams into; removed unless committed. Only error paths unlink,
+    // so doing it inline on the loop is acceptable.
+    struct UploadFile {
+        AsyncFile file;
+        std::string path;
+        off_t size = 0;
+        bool committed = false;
+
+        explicit UploadFile(AsyncLoop& loop) : file(loop) {}
+        ~UploadFile() {
+            if (!path.empty() && !committed) unlink(path.c_str());
         }
+    };
+
+    // Streams the editor's {"filename": ..., "content": ...} upload to disk: content is
+    // JSON-decoded as it arrives and Caesar-encoded SAVE_CHUNK bytes at a time into a temp
+    // file, which is renamed over the target once complete. Memory use is flat in the file
+    // size, and readers never see a half-written file.
+    Task<void> handleSave(AsyncConnection& conn, RequestBody& body, bool keepAlive) {
+        AsyncLoop& loop = conn.asyncLoop();
+        JsonStringObject json;
+        std::string filename, pending, input;
+        bool filenameDone = false, contentDone = false, invalid = false;
+        auto sink = [&](std::string_view key, std::string_view piece, bool end) {
+            if (key == "filename") {
+                invalid |= filenameDone || filename.size() + piece.size() > MAX_FILENAME;
+                if (end) filenameDone = true;
+                else if (!invalid) filename.append(piece);
+            } else if (key == "content") {
+                invalid |= contentDone;
+                if (end) contentDone = true;
+                else pending.append(piece);
+            }
+        };
+
+        UploadFile upload(loop);
+        bool filenameChecked = false;
+        while (!json.complete()) {
+            input.clear();
+            if (body.done()) {
+                sendError(conn, 400, "Invalid JSON", keepAlive);
+                co_return;
+            }
+            if (!co_await body.read(input, SAVE_CHUNK)) {
+                int code = body.errorCode();
+                sendError(conn, code, code == 408 ? "Request Timeout" : HttpParser::errorReason(code), keepAlive);
+                co_return;
+            }
+            if (json.feed(input, sink) == JsonStringObject::Status::Error || invalid) {
+                sendError(conn, 400, "Invalid JSON", keepAlive);
+                co_return;
+            }
 
-        filenamePos += 11; // Skip "filename":"
-        size_t filenameEnd = body.find('"', filenamePos);
-        std::string filename = body.substr(filenamePos, filenameEnd - filenamePos);
+            if (filenameDone && !filenameChecked) {
+                filenameChecked = true;
+                // Security check
+                if (filename.find("..") != std::string::npos) {
+                    sendError(conn, 403, "Forbidden", keepAlive);
+                    co_return;
+                }
+                if (filename.empty() || filename.find('\0') != std::string::npos) {
+                    sendError(conn, 400, "Invalid JSON", keepAlive);
+                    co_return;
+                }
+            }
 
-        contentPos += 9; // Skip "content":"
-        size_t contentEnd = body.find('"', contentPos);
-        std::string content = body.substr(contentPos, contentEnd - contentPos);
+            if (pending.size() >= SAVE_CHUNK && !co_await writeUploadChunk(loop, upload, filename, pending)) {
+                sendError(conn, 500, "Failed to save file", keepAlive);
+                co_return;
+            }
+        }
 
-        // Security check
-        if (filename.find("..") != std::string::npos) {
-            sendError(clientSocket, 403, "Forbidden");
-            return;
+        if (!filenameDone || !contentDone) {
+            sendError(conn, 400, "Invalid JSON", keepAlive);
+            co_return;
+        }
+        if (!co_await writeUploadChunk(loop, upload, filename, pending)) {
+            sendError(conn, 500, "Failed to save file", keepAlive);
+            co_return;
         }
 
+        // Commit: flush the data, then atomically replace the target
         std::string fullPath = rootDir + "/" + filename;
+        bool committed = co_await loop.offload([&]() {
+            std::error_code error;
+            fs::create_directories(fs::path(fullPath).parent_path(), error);
+            return fdatasync(upload.file.fd()) == 0 && rename(upload.path.c_str(), fullPath.c_str()) == 0;
+        });
+        if (!committed) {
+            std::cerr << "Save error: " << fullPath << ": " << strerror(errno) << std::endl;
+            sendError(conn, 500, "Failed to save file", keepAlive);
+            co_return;
+        }
+        upload.committed = true;
 
-        try {
-            // Create directory if needed
-            fs::path filePath(fullPath);
-            fs::create_directories(filePath.parent_path());
-
-            if (writeEncryptedFile(fullPath, content)) {
-                std::string response = "HTTP/1.1 200 OK\r\n"
-                                     "Content-Type: application/json; charset=utf-8\r\n"
-                                     "Content-Length: 17\r\n"
-                                     "Connection: close\r\n"
-                                     "\r\n{\"status\":\"success\"}";
+        std::string response = "{\"status\":\"success\",\"bytes\":" + std::to_string(upload.size) + "}";
+        writeHead(conn, "200 OK", "application/json", response.size(), keepAlive);
+        sendBody(conn, std::move(response));
+    }
 
-                send(clientSocket, response.c_str(), response.size(), 0);
-            } else {
-                sendError(clientSocket, 500, "Failed to save file");
+    // Encrypt and append `pending` to the upload, creating its temp file on first use: next
+    // to the target when the filename has arrived, in the root directory otherwise
+    Task<bool> writeUploadChunk(AsyncLoop& loop, UploadFile& upload, const std::string& filename, std::string& pending) {
+        if (upload.path.empty()) {
+            fs::path directory = filename.empty() ? fs::path(rootDir) : fs::path(rootDir + "/" + filename).parent_path();
+            std::string path = (directory / (".save-" + std::to_string(getpid()) + "-" +
+                                             std::to_string(uploadCounter.fetch_add(1)) + ".tmp")).string();
+            co_await loop.offload([&]() {
+                std::error_code error;
+                return fs::create_directories(directory, error);
+            });
+            if (co_await upload.file.open(path, O_WRONLY | O_CREAT | O_EXCL) < 0) {
+                std::cerr << "Save error: " << path << ": " << strerror(errno) << std::endl;
+                co_return false;
             }
-        } catch (const std::exception& e) {
-            std::cerr << "Save error: " << e.what() << std::endl;
-            sendError(clientSocket, 500, "Internal Server Error");
+            upload.path = path;
         }
+
+        CaesarCipher::encryptInPlace(pending.data(), pending.size());
+        ssize_t written = co_await upload.file.write(pending.data(), pending.size(), upload.size);
+        if (written != (ssize_t)pending.size()) co_return false;
+        upload.size += written;
+        pending.clear();
+        co_return true;
     }
 
-    void sendError(int clientSocket, int code, const std::string& message) {
-        std::string response = "HTTP/1.1 " + std::to_string(code) + " " + message + "\r\n"
-                             "Content-Type: text/plain; charset=utf-8\r\n"
-                             "Connection: close\r\n"
-                             "\r\n" + message;
+    static void writePartialHead(AsyncConnection& conn, const RangeResponse& partial, std::string_view validators,
+                                 bool keepAlive) {
+        ResponseWriter(conn.output()).status("206 Partial Content").headers(partial.headers())
+            .headers(validators).headers(connectionHeader(keepAlive)).end();
+    }
+
+    static void sendRangeNotSatisfiable(AsyncConnection& conn, uint64_t size, bool keepAlive) {
+        sendError(conn, 416, "Range Not Satisfiable", keepAlive,
+                  "Content-Range: " + ByteRange::unsatisfiedRange(size) + "\r\n");
+    }
 
-        send(clientSocket, response.c_str(), response.size(), 0);
+    static void sendError(AsyncConnection& conn, int code, std::string_view message, bool keepAlive,
+                          std::string_view extraHeaders = "") {
+        ResponseWriter(conn.output()).status(code, message)
+            .header("Content-Type", "text/plain; charset=utf-8")
+            .header("Content-Length", (uint64_t)message.size())
+            .headers(extraHeaders).headers(connectionHeader(keepAlive)).end();
+        conn.output().append(message);
     }
 };
 
 int main(int argc, char* argv[]) {
     bool daemonMode = false;
+    size_t workerThreads = 0;
+    int listeners = 1;
+    int backlog = SOMAXCONN;
+    bool pinCpus = false;
 
-    // Check for daemon mode flag
+    // Check for daemon mode, worker pool and listener flags
     for (int i = 1; i < argc; i++) {
-        if (std::string(argv[i]) == "--daemon") {
+        std::string arg = argv[i];
+        if (arg == "--daemon") {
             daemonMode = true;
+        } else if ((arg == "--workers" || arg == "-w") && i + 1 < argc) {
+            workerThreads = std::stoul(argv[++i]);
+        } else if (arg == "--listeners" && i + 1 < argc) {
+            listeners = std::stoi(argv[++i]);
+        } else if (arg == "--backlog" && i + 1 < argc) {
+            backlog = std::stoi(argv[++i]);
+        } else if (arg == "--pin-cpus") {
+            pinCpus = true;
         }
     }
 
@@ -563,7 +873,7 @@ int main(int argc, char* argv[]) {
         std::cout << "🔧 Building C++ ASM Browser/Editor/Server..." << std::endl;
     }
 
-    CPPHTTPServer server(8000, ".");
+    CPPHTTPServer server(8000, ".", workerThreads, listeners, backlog, pinCpus);
 
     if (!server.start()) {
         std::cerr << "❌ Failed to start server" << std::endl;
@@ -0,0 +1,131 @@
+#ifndef EVENT_LOOP_H
+#define EVENT_LOOP_H
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+// Edge-triggered epoll reactor. One EventLoop is driven by exactly one thread;
+// every registered fd carries a Handler that is invoked with the ready mask.
+class EventLoop {
+public:
+    class Handler {
+    public:
+        virtual ~Handler() = default;
+        virtual void onEvents(uint32_t events) = 0;
+    };
+
+    EventLoop()
+        : epollFd(epoll_create1(EPOLL_CLOEXEC)),
+          wakeFd(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)),
+          running(false) {
+        if (epollFd >= 0 && wakeFd >= 0) {
+            epoll_event ev{};
+            ev.events = EPOLLIN;
+            ev.data.ptr = nullptr; // nullptr marks the wakeup eventfd
+            epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeFd, &ev);
+        }
+    }
+
+    ~EventLoop() {
+        if (wakeFd >= 0) close(wakeFd);
+        if (epollFd >= 0) close(epollFd);
+    }
+
+    EventLoop(const EventLoop&) = delete;
+    EventLoop& operator=(const EventLoop&) = delete;
+
+    bool valid() const { return epollFd >= 0 && wakeFd >= 0; }
+
+    bool add(int fd, uint32_t events, Handler* handler) {
+        epoll_event ev{};
+        ev.events = events;
+        ev.data.ptr = handler;
+        return epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &ev) == 0;
+    }
+
+    bool modify(int fd, uint32_t events, Handler* handler) {
+        epoll_event ev{};
+        ev.events = events;
+        ev.data.ptr = handler;
+        return epoll_ctl(epollFd, EPOLL_CTL_MOD, fd, &ev) == 0;
+    }
+
+    void remove(int fd) {
+        epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+    }
+
+    // remove() for a handler that may be destroyed by another handler of the same batch:
+    // its events still waiting in the batch are dropped rather than dispatched
+    void remove(int fd, Handler* handler) {
+        remove(fd);
+        for (int i = batchNext; i < batchSize; i++) {
+            if (batch[i].data.ptr == handler) batch[i].events = 0;
+        }
+    }
+
+    // Dispatch events until stop() is called from any thread. When tickMs > 0,
+    // onTick runs roughly every tickMs for housekeeping such as idle timeouts.
+    void run(int tickMs = -1, const std::function<void()>& onTick = nullptr) {
+        running = true;
+        epoll_event events[256];
+        auto lastTick = std::chrono::steady_clock::now();
+        batch = events;
+        while (running) {
+            int n = epoll_wait(epollFd, events, 256, onTick ? tickMs : -1);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                break;
+            }
+            batchSize = n;
+            for (int i = 0; i < n; i++) {
+                batchNext = i + 1;
+                if (events[i].events == 0) continue; // handler removed earlier in this batch
+                Handler* handler = static_cast<Handler*>(events[i].data.ptr);
+                if (!handler) {
+                    uint64_t value;
+                    while (read(wakeFd, &value, sizeof(value)) > 0) {}
+                    continue;
+                }
+                handler->onEvents(events[i].events);
+            }
+            batchSize = 0;
+
+            if (onTick) {
+                auto now = std::chrono::steady_clock::now();
+                if (now - lastTick >= std::chrono::milliseconds(tickMs)) {
+                    lastTick = now;
+                    onTick();
+                }
+            }
+        }
+    }
+
+    void stop() {
+        running = false;
+        uint64_t one = 1;
+        ssize_t ignored = write(wakeFd, &one, sizeof(one));
+        (void)ignored;
+    }
+
+    static bool setNonBlocking(int fd) {
+        int flags = fcntl(fd, F_GETFL, 0);
+        return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+    }
+
+private:
+    int epollFd;
+    int wakeFd;
+    std::atomic<bool> running;
+    epoll_event* batch = nullptr; // events being dispatched by run()
+    int batchNext = 0;
+    int batchSize = 0;
+};
+
+#endif // EVENT_LOOP_H
@@ -0,0 +1,566 @@
+#ifndef HTTP_PARSER_H
+#define HTTP_PARSER_H
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+struct HttpHeader {
+    std::string_view name;
+    std::string_view value;
+};
+
+// A parsed request. Every view points into the connection buffer handed to
+// HttpParser::parse() (or, for chunked bodies, into the parser itself), so it
+// is only valid until that buffer is modified or the parser is reset.
+struct HttpRequest {
+    std::string_view method;
+    std::string_view target;  // path plus query, as sent
+    std::string_view path;
+    std::string_view query;
+    std::string_view version;
+    std::vector<HttpHeader> headers;
+    std::string_view body;
+    size_t contentLength = 0;
+    bool chunked = false;
+    bool keepAlive = false;
+
+    static bool equalsIgnoreCase(std::string_view a, std::string_view b) {
+        if (a.size() != b.size()) return false;
+        for (size_t i = 0; i < a.size(); i++) {
+            if (std::tolower((unsigned char)a[i]) != std::tolower((unsigned char)b[i])) return false;
+        }
+        return true;
+    }
+
+    // First header with this name (case-insensitive); empty if absent
+    std::string_view header(std::string_view name) const {
+        for (const auto& h : headers) {
+            if (equalsIgnoreCase(h.name, name)) return h.value;
+        }
+        return std::string_view();
+    }
+
+    // Whether a comma-separated header such as Connection lists `token`
+    bool headerHasToken(std::string_view name, std::string_view token) const {
+        for (const auto& h : headers) {
+            if (!equalsIgnoreCase(h.name, name)) continue;
+            std::string_view list = h.value;
+            while (!list.empty()) {
+                size_t comma = list.find(',');
+                std::string_view item = list.substr(0, comma);
+                while (!item.empty() && (item.front() == ' ' || item.front() == '\t')) item.remove_prefix(1);
+                while (!item.empty() && (item.back() == ' ' || item.back() == '\t')) item.remove_suffix(1);
+                if (equalsIgnoreCase(item, token)) return true;
+                if (comma == std::string_view::npos) break;
+                list.remove_prefix(comma + 1);
+            }
+        }
+        return false;
+    }
+};
+
+// Resumable HTTP/1.1 request parser. Call parse() each time more bytes are
+// appended to the connection buffer; it continues from where it stopped and
+// never rescans consumed bytes. Positions are kept as offsets while parsing so
+// the buffer may reallocate between calls; views are produced on completion.
+class HttpParser {
+public:
+    enum class Status { Incomplete, Complete, Error };
+
+    explicit HttpParser(size_t maxHeaderBytes = 64 * 1024, size_t maxBodyBytes = 8 * 1024 * 1024)
+        : maxHeaderBytes(maxHeaderBytes), maxBodyBytes(maxBodyBytes) {
+        reset();
+    }
+
+    // Forget the current request; the next parse() starts at offset 0 of its buffer
+    void reset() {
+        state = State::RequestLine;
+        offset = 0;
+        lineStart = 0;
+        errorStatus = 0;
+        bodyStart = 0;
+        trailerStart = 0;
+        chunkRemaining = 0;
+        pathLength = 0;
+        headOnly = false;
+        spans.clear();
+        decodedBody.clear();
+        parsed.headers.clear();
+        parsed.contentLength = 0;
+        parsed.chunked = false;
+        parsed.keepAlive = false;
+    }
+
+    Status parse(std::string_view buffer) {
+        while (true) {
+            switch (state) {
+            case State::RequestLine:
+            case State::HeaderLine:
+            case State::Trailer: {
+                // The head (or trailer section) is bounded whether its lines arrive one
+                // at a time or all in one read
+                size_t lineEnd;
+                bool lineComplete = nextLine(buffer, lineEnd);
+                size_t sectionStart = state == State::Trailer ? trailerStart : 0;
+                if ((lineComplete ? offset : buffer.size()) - sectionStart > maxHeaderBytes) return fail(431);
+                if (!lineComplete) return Status::Incomplete;
+                std::string_view line = buffer.substr(lineStart, lineEnd - lineStart);
+                size_t start = lineStart;
+                lineStart = offset;
+
+                if (state == State::RequestLine) {
+                    if (line.empty()) continue; // tolerate stray CRLF between pipelined requests
+                    int status = parseRequestLine(line, start);
+                    if (status != 0) return fail(status);
+                    state = State::HeaderLine;
+                } else if (state == State::HeaderLine) {
+                    if (line.empty()) {
+                        if (!finishHead(buffer)) return Status::Error;
+                        continue;
+                    }
+                    if (!parseHeaderLine(line, start)) return fail(400);
+                } else if (line.empty()) {
+                    return complete(buffer);
+                }
+                break;
+            }
+
+            case State::Body:
+                if (buffer.size() - bodyStart < parsed.contentLength) return Status::Incomplete;
+                offset = bodyStart + parsed.contentLength;
+                return complete(buffer);
+
+            case State::ChunkSize: {
+                size_t lineEnd;
+                if (!nextLine(buffer, lineEnd)) {
+                    if (buffer.size() - lineStart > 1024) return fail(400);
+                    return Status::Incomplete;
+                }
+                std::string_view line = buffer.substr(lineStart, lineEnd - lineStart);
+                lineStart = offset;
+                size_t size = 0, digits = 0;
+                for (char c : line) {
+                    int value = hexValue(c);
+                    if (value < 0) break;
+                    if (size > (SIZE_MAX >> 4)) return fail(413);
+                    size = (size << 4) | (size_t)value;
+                    digits++;
+                }
+                if (digits == 0) return fail(400);
+                if (size == 0) {
+                    trailerStart = offset;
+                    state = State::Trailer;
+                    continue;
+                }
+                if (decodedBody.size() + size > maxBodyBytes) return fail(413);
+                chunkRemaining = size;
+                state = State::ChunkData;
+                break;
+            }
+
+            case State::ChunkData: {
+                size_t available = buffer.size() - offset;
+                size_t take = available < chunkRemaining ? available : chunkRemaining;
+                decodedBody.append(buffer.data() + offset, take);
+                offset += take;
+                chunkRemaining -= take;
+                if (chunkRemaining > 0) return Status::Incomplete;
+                state = State::ChunkDataEnd;
+                break;
+            }
+
+            case State::ChunkDataEnd: {
+                if (buffer.size() - offset < 2) return Status::Incomplete;
+                if (buffer[offset] != '\r' || buffer[offset + 1] != '\n') return fail(400);
+                offset += 2;
+                lineStart = offset;
+                state = State::ChunkSize;
+                break;
+            }
+
+            case State::Done:
+                return Status::Complete;
+
+            case State::Failed:
+                return Status::Error;
+            }
+        }
+    }
+
+    // Like parse(), but stops once the head is complete and leaves the body, however
+    // large, in the buffer for an HttpBodyReader; the body size limit does not apply.
+    // On Complete, request() has an empty body and consumed() covers the head only.
+    Status parseHead(std::string_view buffer) {
+        headOnly = true;
+        return parse(buffer);
+    }
+
+    // Valid after Status::Complete
+    const HttpRequest& request() const { return parsed; }
+
+    // Bytes of the buffer occupied by the completed request (head and body)
+    size_t consumed() const { return offset; }
+
+    // Head parsed, body (or chunk trailer) still arriving
+    bool readingBody() const {
+        return state == State::Body || state == State::ChunkSize || state == State::ChunkData ||
+               state == State::ChunkDataEnd || state == State::Trailer;
+    }
+
+    // Suggested response status after Status::Error (400, 413, 431, 501 or 505)
+    int errorCode() const { return errorStatus; }
+
+    static const char* errorReason(int status) {
+        switch (status) {
+        case 413: return "Payload Too Large";
+        case 431: return "Request Header Fields Too Large";
+        case 501: return "Not Implemented";
+        case 505: return "HTTP Version Not Supported";
+        default: return "Bad Request";
+        }
+    }
+
+private:
+    enum class State { RequestLine, HeaderLine, Body, ChunkSize, ChunkData, ChunkDataEnd, Trailer, Done, Failed };
+
+    struct Span {
+        uint32_t start, length;
+    };
+
+    struct HeaderSpan {
+        Span name, value;
+    };
+
+    size_t maxHeaderBytes;
+    size_t maxBodyBytes;
+    State state;
+    size_t offset;      // next unexamined byte
+    size_t lineStart;   // start of the line being assembled
+    int errorStatus;
+    size_t bodyStart;
+    size_t trailerStart; // first byte after the last chunk's size line
+    size_t chunkRemaining;
+    Span methodSpan, targetSpan, versionSpan;
+    size_t pathLength;
+    bool headOnly;
+    std::vector<HeaderSpan> spans;
+    std::string decodedBody;
+    HttpRequest parsed;
+
+    Status fail(int status) {
+        errorStatus = status;
+        state = State::Failed;
+        return Status::Error;
+    }
+
+    static int hexValue(char c) {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        return -1;
+    }
+
+    // Advance to the end of the current line; lineEnd excludes CRLF (or a bare LF)
+    bool nextLine(std::string_view buffer, size_t& lineEnd) {
+        if (offset >= buffer.size()) return false;
+        const void* found = std::memchr(buffer.data() + offset, '\n', buffer.size() - offset);
+        if (!found) {
+            offset = buffer.size();
+            return false;
+        }
+        size_t newline = (const char*)found - buffer.data();
+        lineEnd = (newline > lineStart && buffer[newline - 1] == '\r') ? newline - 1 : newline;
+        offset = newline + 1;
+        return true;
+    }
+
+    // 0 when the line is valid, otherwise the status to answer with: 505 for a well-formed
+    // version other than HTTP/1.0 and HTTP/1.1, 400 for anything malformed
+    int parseRequestLine(std::string_view line, size_t start) {
+        size_t firstSpace = line.find(' ');
+        if (firstSpace == std::string_view::npos || firstSpace == 0) return 400;
+        size_t secondSpace = line.find(' ', firstSpace + 1);
+        if (secondSpace == std::string_view::npos || secondSpace == firstSpace + 1) return 400;
+
+        std::string_view version = line.substr(secondSpace + 1);
+        if (version.size() != 8 || version.compare(0, 5, "HTTP/") != 0 || version[6] != '.' ||
+            !std::isdigit((unsigned char)version[5]) || !std::isdigit((unsigned char)version[7])) {
+            return 400;
+        }
+        if (version[5] != '1' || (version[7] != '0' && version[7] != '1')) return 505;
+
+        for (size_t i = 0; i < firstSpace; i++) {
+            if (!std::isupper((unsigned char)line[i])) return 400;
+        }
+
+        std::string_view target = line.substr(firstSpace + 1, secondSpace - firstSpace - 1);
+        pathLength = target.find('?');
+        if (pathLength == std::string_view::npos) pathLength = target.size();
+
+        methodSpan = {(uint32_t)start, (uint32_t)firstSpace};
+        targetSpan = {(uint32_t)(start + firstSpace + 1), (uint32_t)target.size()};
+        versionSpan = {(uint32_t)(start + secondSpace + 1), 8};
+        return 0;
+    }
+
+    bool parseHeaderLine(std::string_view line, size_t start) {
+        if (line.front() == ' ' || line.front() == '\t') return false; // obsolete line folding
+        size_t colon = line.find(':');
+        if (colon == std::string_view::npos || colon == 0) return false;
+        for (size_t i = 0; i < colon; i++) {
+            if (line[i] == ' ' || line[i] == '\t') return false;
+        }
+        size_t valueStart = colon + 1;
+        size_t valueEnd = line.size();
+        while (valueStart < valueEnd && (line[valueStart] == ' ' || line[valueStart] == '\t')) valueStart++;
+        while (valueEnd > valueStart && (line[valueEnd - 1] == ' ' || line[valueEnd - 1] == '\t')) valueEnd--;
+        spans.push_back({{(uint32_t)start, (uint32_t)colon},
+                         {(uint32_t)(start + valueStart), (uint32_t)(valueEnd - valueStart)}});
+        return true;
+    }
+
+    static std::string_view view(std::string_view buffer, Span span) {
+        return buffer.substr(span.start, span.length);
+    }
+
+    // Materialize views over the buffer; called whenever the buffer may have moved
+    void bindViews(std::string_view buffer) {
+        parsed.method = view(buffer, methodSpan);
+        parsed.target = view(buffer, targetSpan);
+        parsed.version = view(buffer, versionSpan);
+        parsed.path = parsed.target.substr(0, pathLength);
+        parsed.query = pathLength < parsed.target.size() ? parsed.target.substr(pathLength + 1) : std::string_view();
+        parsed.headers.clear();
+        for (const HeaderSpan& span : spans) {
+            parsed.headers.push_back({view(buffer, span.name), view(buffer, span.value)});
+        }
+    }
+
+    // Headers are complete: decide how the body is framed
+    bool finishHead(std::string_view buffer) {
+        bindViews(buffer);
+
+        std::string_view transferEncoding = parsed.header("Transfer-Encoding");
+        std::string_view contentLength;
+        for (const auto& h : parsed.headers) {
+            if (!HttpRequest::equalsIgnoreCase(h.name, "Content-Length")) continue;
+            if (!contentLength.empty() && contentLength != h.value) {
+                fail(400);
+                return false;
+            }
+            contentLength = h.value;
+        }
+
+        if (!transferEncoding.empty()) {
+            // A request carrying both framings is a smuggling vector; refuse it
+            if (!contentLength.empty()) {
+                fail(400);
+                return false;
+            }
+            if (!parsed.headerHasToken("Transfer-Encoding", "chunked")) {
+                fail(501);
+                return false;
+            }
+            parsed.chunked = true;
+            if (headOnly) return completeHead();
+            lineStart = offset;
+            state = State::ChunkSize;
+            return true;
+        }
+
+        if (!contentLength.empty()) {
+            size_t length = 0;
+            for (char c : contentLength) {
+                if (c < '0' || c > '9' || length > (SIZE_MAX - 9) / 10) {
+                    fail(400);
+                    return false;
+                }
+                length = length * 10 + (size_t)(c - '0');
+            }
+            if (length > maxBodyBytes && !headOnly) {
+                fail(413);
+                return false;
+            }
+            parsed.contentLength = length;
+        }
+
+        if (headOnly) return completeHead();
+        bodyStart = offset;
+        state = State::Body;
+        return true;
+    }
+
+    Status complete(std::string_view buffer) {
+        bindViews(buffer);
+        if (parsed.chunked) {
+            parsed.body = decodedBody;
+            parsed.contentLength = decodedBody.size();
+        } else {
+            parsed.body = buffer.substr(bodyStart, parsed.contentLength);
+        }
+        decideKeepAlive();
+        state = State::Done;
+        return Status::Complete;
+    }
+
+    bool completeHead() {
+        parsed.body = std::string_view();
+        decideKeepAlive();
+        state = State::Done;
+        return true;
+    }
+
+    // HTTP/1.1 connections persist unless the client says close; HTTP/1.0 must opt in
+    void decideKeepAlive() {
+        if (parsed.headerHasToken("Connection", "close")) {
+            parsed.keepAlive = false;
+        } else if (parsed.headerHasToken("Connection", "keep-alive")) {
+            parsed.keepAlive = true;
+        } else {
+            parsed.keepAlive = parsed.version == "HTTP/1.1";
+        }
+    }
+};
+
+// Incremental decoder for a request body read after HttpParser::parseHead(): strips the
+// Content-Length or chunked framing from the front of the connection buffer as bytes
+// arrive, so a body of any size passes through a fixed amount of memory. Bytes after
+// the body (a pipelined request) are left in the buffer.
+class HttpBodyReader {
+public:
+    enum class Status { Incomplete, Complete, Error };
+
+    HttpBodyReader(size_t contentLength, bool chunked, size_t maxBodyBytes = SIZE_MAX)
+        : maxBodyBytes(maxBodyBytes), remaining(contentLength), total(0), errorStatus(0) {
+        if (chunked) {
+            state = State::ChunkSize;
+        } else if (contentLength > maxBodyBytes) {
+            fail(413);
+        } else {
+            state = contentLength > 0 ? State::Data : State::Done;
+        }
+    }
+
+    // Move up to maxBytes of decoded body from the front of `input` to the end of `out`,
+    // erasing the framing and data consumed. Incomplete means more input is needed (or
+    // maxBytes was reached).
+    Status read(std::string& input, std::string& out, size_t maxBytes) {
+        size_t position = 0;
+        Status status = decode(input, position, out, maxBytes);
+        input.erase(0, position);
+        return status;
+    }
+
+    bool done() const { return state == State::Done; }
+    bool failed() const { return state == State::Failed; }
+    size_t bodyBytes() const { return total; }
+
+    // Decoded bytes still expected; unknown for chunked bodies (SIZE_MAX)
+    size_t remainingBytes() const {
+        if (state == State::Done) return 0;
+        return state == State::Data ? remaining : SIZE_MAX;
+    }
+
+    // Suggested response status once failed(): 400 or 413
+    int errorCode() const { return errorStatus; }
+
+private:
+    enum class State { Data, ChunkSize, ChunkData, ChunkDataEnd, Trailer, Done, Failed };
+
+    size_t maxBodyBytes;
+    State state;
+    size_t remaining; // of the body (Data) or of the current chunk (ChunkData)
+    size_t total;
+    int errorStatus;
+
+    Status fail(int status) {
+        errorStatus = status;
+        state = State::Failed;
+        return Status::Error;
+    }
+
+    // One CRLF (or bare LF) terminated line at `position`; false until it is complete
+    static bool line(std::string_view input, size_t& position, std::string_view& text) {
+        size_t newline = input.find('\n', position);
+        if (newline == std::string_view::npos) return false;
+        text = input.substr(position, newline - position);
+        if (!text.empty() && text.back() == '\r') text.remove_suffix(1);
+        position = newline + 1;
+        return true;
+    }
+
+    Status decode(std::string_view input, size_t& position, std::string& out, size_t maxBytes) {
+        size_t produced = 0;
+        while (true) {
+            switch (state) {
+            case State::Data:
+            case State::ChunkData: {
+                size_t take = std::min(std::min(remaining, input.size() - position), maxBytes - produced);
+                out.append(input.data() + position, take);
+                position += take;
+                produced += take;
+                total += take;
+                remaining -= take;
+                if (remaining == 0) {
+                    state = state == State::Data ? State::Done : State::ChunkDataEnd;
+                    break;
+                }
+                return Status::Incomplete;
+            }
+
+            case State::ChunkSize: {
+                std::string_view text;
+                if (!line(input, position, text)) {
+                    if (input.size() - position > 1024) return fail(400);
+                    return Status::Incomplete;
+                }
+                size_t size = 0, digits = 0;
+                for (char c : text) {
+                    int value = c >= '0' && c <= '9' ? c - '0'
+                              : c >= 'a' && c <= 'f' ? c - 'a' + 10
+                              : c >= 'A' && c <= 'F' ? c - 'A' + 10 : -1;
+                    if (value < 0) break; // chunk extensions are ignored
+                    if (size > (SIZE_MAX >> 4)) return fail(413);
+                    size = (size << 4) | (size_t)value;
+                    digits++;
+                }
+                if (digits == 0) return fail(400);
+                if (size > maxBodyBytes - total) return fail(413);
+                remaining = size;
+                state = size == 0 ? State::Trailer : State::ChunkData;
+                break;
+            }
+
+            case State::ChunkDataEnd:
+                if (input.size() - position < 2) return Status::Incomplete;
+                if (input[position] != '\r' || input[position + 1] != '\n') return fail(400);
+                position += 2;
+                state = State::ChunkSize;
+                break;
+
+            case State::Trailer: {
+                std::string_view text;
+                if (!line(input, position, text)) {
+                    if (input.size() - position > 8192) return fail(400);
+                    return Status::Incomplete;
+                }
+                if (text.empty()) state = State::Done;
+                break;
+            }
+
+            case State::Done:
+                return Status::Complete;
+
+            case State::Failed:
+                return Status::Error;
+            }
+        }
+    }
+};
+
+#endif // HTTP_PARSER_H
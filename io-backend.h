@@ -0,0 +1,16 @@
+#ifndef IO_BACKEND_H
+#define IO_BACKEND_H
+
+// How a server drives its accepted connections: a worker thread pool, epoll reactors
+// or io_uring rings. run() serves the server's listening sockets on the calling thread
+// (plus any threads it starts) until stop() is called from another thread.
+class IoBackend {
+public:
+    virtual ~IoBackend() = default;
+
+    virtual const char* name() const = 0;
+    virtual void run() = 0;
+    virtual void stop() = 0;
+};
+
+#endif // IO_BACKEND_H
@@ -0,0 +1,283 @@
+#ifndef IO_URING_H
+#define IO_URING_H
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <memory>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+// Minimal io_uring binding over the raw syscalls, so the server needs no liburing.
+// One ring is driven by exactly one thread: fill SQEs from sqe(), then submitAndWait()
+// and drain completions with forEachCompletion(). A ring can own one provided buffer
+// group (recv takes a buffer only once data arrives, so idle connections hold no
+// memory) and a set of registered buffers for fixed reads.
+class IoUring {
+public:
+    explicit IoUring(unsigned entries) {
+        io_uring_params params{};
+        // One submitting thread and task work run only when we wait: fewer interrupts.
+        // Older kernels reject the flags, so retry without them.
+        params.flags = IORING_SETUP_SINGLE_ISSUER | IORING_SETUP_DEFER_TASKRUN;
+        ringFd = (int)syscall(__NR_io_uring_setup, entries, &params);
+        if (ringFd < 0 && errno == EINVAL) {
+            params = io_uring_params{};
+            ringFd = (int)syscall(__NR_io_uring_setup, entries, &params);
+        }
+        if (ringFd < 0) return;
+        features = params.features;
+
+        sqRingSize = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+        cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        if (features & IORING_FEAT_SINGLE_MMAP) sqRingSize = cqRingSize = std::max(sqRingSize, cqRingSize);
+
+        sqRing = mmap(nullptr, sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQ_RING);
+        if (sqRing == MAP_FAILED) {
+            fail();
+            return;
+        }
+        cqRing = (features & IORING_FEAT_SINGLE_MMAP)
+                     ? sqRing
+                     : mmap(nullptr, cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_CQ_RING);
+        if (cqRing == MAP_FAILED) {
+            fail();
+            return;
+        }
+        sqeCount = params.sq_entries;
+        sqes = (io_uring_sqe*)mmap(nullptr, sqeCount * sizeof(io_uring_sqe), PROT_READ | PROT_WRITE,
+                                   MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQES);
+        if (sqes == MAP_FAILED) {
+            fail();
+            return;
+        }
+
+        char* sq = (char*)sqRing;
+        sqHead = (std::atomic<uint32_t>*)(sq + params.sq_off.head);
+        sqTail = (std::atomic<uint32_t>*)(sq + params.sq_off.tail);
+        sqMask = *(uint32_t*)(sq + params.sq_off.ring_mask);
+        uint32_t* array = (uint32_t*)(sq + params.sq_off.array);
+        for (uint32_t i = 0; i < sqeCount; i++) array[i] = i; // SQE slot i always sits at ring index i
+
+        char* cq = (char*)cqRing;
+        cqHead = (std::atomic<uint32_t>*)(cq + params.cq_off.head);
+        cqTail = (std::atomic<uint32_t>*)(cq + params.cq_off.tail);
+        cqMask = *(uint32_t*)(cq + params.cq_off.ring_mask);
+        cqes = (io_uring_cqe*)(cq + params.cq_off.cqes);
+        localTail = sqTail->load(std::memory_order_relaxed);
+    }
+
+    ~IoUring() {
+        if (bufferMemory) munmap(bufferMemory, (size_t)bufferCount * bufferSize);
+        if (fixedMemory) munmap(fixedMemory, (size_t)fixedCount * fixedSize);
+        unmapRings();
+        if (ringFd >= 0) close(ringFd);
+    }
+
+    IoUring(const IoUring&) = delete;
+    IoUring& operator=(const IoUring&) = delete;
+
+    bool valid() const { return ringFd >= 0 && sqes != nullptr; }
+
+    // Whether this kernel has everything the server's ring backend needs: completion
+    // skipping (5.17), timed waits (5.11) and the ops themselves
+    static bool supported() {
+        IoUring ring(8);
+        uint32_t needed = IORING_FEAT_EXT_ARG | IORING_FEAT_NODROP | IORING_FEAT_CQE_SKIP;
+        if (!ring.valid() || (ring.features & needed) != needed) return false;
+        alignas(io_uring_probe) char storage[sizeof(io_uring_probe) + IORING_OP_LAST * sizeof(io_uring_probe_op)] = {};
+        io_uring_probe* probe = (io_uring_probe*)storage;
+        if (ring.registerCall(IORING_REGISTER_PROBE, probe, IORING_OP_LAST) < 0) return false;
+        for (int op : {IORING_OP_ACCEPT, IORING_OP_RECV, IORING_OP_SEND, IORING_OP_SENDMSG, IORING_OP_READ,
+                       IORING_OP_READ_FIXED, IORING_OP_PROVIDE_BUFFERS}) {
+            if (op > probe->last_op || !(probe->ops[op].flags & IO_URING_OP_SUPPORTED)) return false;
+        }
+        return true;
+    }
+
+    // Next free submission entry, zeroed, or nullptr when the queue is full (submit first)
+    io_uring_sqe* sqe() {
+        uint32_t head = sqHead->load(std::memory_order_acquire);
+        if (localTail - head >= sqeCount) return nullptr;
+        io_uring_sqe* entry = &sqes[localTail & sqMask];
+        localTail++;
+        memset(entry, 0, sizeof(*entry));
+        return entry;
+    }
+
+    // Submission entries sqe() can still hand out before the next submit
+    unsigned spaceLeft() const { return sqeCount - (localTail - sqHead->load(std::memory_order_acquire)); }
+
+    // Submit queued entries and wait up to `timeout` for at least one completion
+    int submitAndWait(std::chrono::milliseconds timeout) {
+        uint32_t toSubmit = publish();
+        __kernel_timespec ts{timeout.count() / 1000, (timeout.count() % 1000) * 1000000};
+        io_uring_getevents_arg arg{};
+        arg.sigmask_sz = _NSIG / 8;
+        arg.ts = (uint64_t)(uintptr_t)&ts;
+        int result = (int)syscall(__NR_io_uring_enter, ringFd, toSubmit, 1,
+                                  IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG, &arg, sizeof(arg));
+        return result < 0 ? -errno : result;
+    }
+
+    int submit() {
+        uint32_t toSubmit = publish();
+        if (toSubmit == 0) return 0;
+        int result = (int)syscall(__NR_io_uring_enter, ringFd, toSubmit, 0, 0, nullptr, 0);
+        return result < 0 ? -errno : result;
+    }
+
+    // Hand every ready completion to `handle(const io_uring_cqe&)`; returns how many there were
+    template <typename Handle>
+    unsigned forEachCompletion(Handle&& handle) {
+        unsigned seen = 0;
+        while (true) {
+            uint32_t head = cqHead->load(std::memory_order_relaxed);
+            uint32_t tail = cqTail->load(std::memory_order_acquire);
+            if (head == tail) return seen;
+            for (; head != tail; head++, seen++) {
+                io_uring_cqe cqe = cqes[head & cqMask];
+                // Release the slot before handling: handlers submit, and the kernel may need it
+                cqHead->store(head + 1, std::memory_order_release);
+                if (cqe.user_data != INTERNAL) handle(cqe);
+            }
+        }
+    }
+
+    // Register `count` buffers of `size` bytes for READ_FIXED; buffer i is fixedBuffer(i)
+    bool registerBuffers(unsigned count, unsigned size) {
+        void* memory = mmap(nullptr, (size_t)count * size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (memory == MAP_FAILED) return false;
+        std::unique_ptr<iovec[]> iovecs(new iovec[count]);
+        for (unsigned i = 0; i < count; i++) iovecs[i] = {(char*)memory + (size_t)i * size, size};
+        if (registerCall(IORING_REGISTER_BUFFERS, iovecs.get(), count) < 0) {
+            munmap(memory, (size_t)count * size);
+            return false;
+        }
+        fixedMemory = (char*)memory;
+        fixedCount = count;
+        fixedSize = size;
+        return true;
+    }
+
+    char* fixedBuffer(unsigned index) const { return fixedMemory + (size_t)index * fixedSize; }
+    unsigned fixedBufferSize() const { return fixedSize; }
+
+    // Provide `count` buffers of `size` bytes as group `group` for IOSQE_BUFFER_SELECT
+    // receives. A completion names its buffer in cqe.flags; hand it back with
+    // recycleBuffer() once its bytes are consumed. Call before anything else is in flight.
+    bool setupProvidedBuffers(uint16_t group, unsigned count, unsigned size) {
+        void* memory = mmap(nullptr, (size_t)count * size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (memory == MAP_FAILED) return false;
+        bufferMemory = (char*)memory;
+        bufferCount = count;
+        bufferSize = size;
+        bufferGroupId = group;
+
+        io_uring_sqe* entry = sqe();
+        if (!entry) return false;
+        provide(entry, 0, count);
+        entry->flags = 0;
+        entry->user_data = 0;
+        if (submitAndWait(std::chrono::milliseconds(1000)) < 0) return false;
+        int result = -ETIME;
+        forEachCompletion([&result](const io_uring_cqe& cqe) { result = cqe.res; });
+        return result >= 0;
+    }
+
+    uint16_t bufferGroup() const { return bufferGroupId; }
+
+    // The provided buffer a completion's data landed in, nullptr if it carries none
+    char* selectedBuffer(const io_uring_cqe& cqe) const {
+        if (!(cqe.flags & IORING_CQE_F_BUFFER)) return nullptr;
+        return bufferMemory + (size_t)(cqe.flags >> IORING_CQE_BUFFER_SHIFT) * bufferSize;
+    }
+
+    // Queue the buffer back to the kernel; it goes out with the next submit and posts
+    // no completion of its own
+    void recycleBuffer(const io_uring_cqe& cqe) {
+        if (!(cqe.flags & IORING_CQE_F_BUFFER)) return;
+        io_uring_sqe* entry = sqe();
+        if (!entry) {
+            submit();
+            entry = sqe();
+        }
+        if (entry) provide(entry, cqe.flags >> IORING_CQE_BUFFER_SHIFT, 1);
+    }
+
+    // user_data of completions the ring posts for its own housekeeping; skipped
+    static constexpr uint64_t INTERNAL = ~0ull;
+
+private:
+    int ringFd = -1;
+    uint32_t features = 0;
+    void* sqRing = nullptr;
+    void* cqRing = nullptr;
+    size_t sqRingSize = 0;
+    size_t cqRingSize = 0;
+    io_uring_sqe* sqes = nullptr;
+    uint32_t sqeCount = 0;
+    std::atomic<uint32_t>* sqHead = nullptr;
+    std::atomic<uint32_t>* sqTail = nullptr;
+    uint32_t sqMask = 0;
+    uint32_t localTail = 0; // entries handed out by sqe(), published on submit
+    std::atomic<uint32_t>* cqHead = nullptr;
+    std::atomic<uint32_t>* cqTail = nullptr;
+    uint32_t cqMask = 0;
+    io_uring_cqe* cqes = nullptr;
+
+    char* fixedMemory = nullptr;
+    unsigned fixedCount = 0;
+    unsigned fixedSize = 0;
+
+    char* bufferMemory = nullptr;
+    unsigned bufferCount = 0;
+    unsigned bufferSize = 0;
+    uint16_t bufferGroupId = 0;
+
+    void fail() {
+        unmapRings();
+        close(ringFd);
+        ringFd = -1;
+    }
+
+    void unmapRings() {
+        if (sqes && sqes != MAP_FAILED) munmap(sqes, sqeCount * sizeof(io_uring_sqe));
+        if (cqRing && cqRing != MAP_FAILED && cqRing != sqRing) munmap(cqRing, cqRingSize);
+        if (sqRing && sqRing != MAP_FAILED) munmap(sqRing, sqRingSize);
+        sqes = nullptr;
+        sqRing = cqRing = nullptr;
+    }
+
+    uint32_t publish() {
+        uint32_t published = sqTail->load(std::memory_order_relaxed);
+        sqTail->store(localTail, std::memory_order_release);
+        return localTail - published;
+    }
+
+    int registerCall(unsigned opcode, void* arg, unsigned count) {
+        int result = (int)syscall(__NR_io_uring_register, ringFd, opcode, arg, count);
+        return result < 0 ? -errno : result;
+    }
+
+    void provide(io_uring_sqe* entry, unsigned firstId, unsigned count) {
+        entry->opcode = IORING_OP_PROVIDE_BUFFERS;
+        entry->fd = (int)count;
+        entry->addr = (uint64_t)(uintptr_t)(bufferMemory + (size_t)firstId * bufferSize);
+        entry->len = bufferSize;
+        entry->off = firstId;
+        entry->buf_group = bufferGroupId;
+        entry->flags = IOSQE_CQE_SKIP_SUCCESS;
+        entry->user_data = INTERNAL;
+    }
+};
+
+#endif // IO_URING_H
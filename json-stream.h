@@ -0,0 +1,246 @@
+#ifndef JSON_STREAM_H
+#define JSON_STREAM_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// Single-pass decoder for a flat JSON object of string values, such as the editor's
+// {"filename": "...", "content": "..."}, fed in pieces of any size as they arrive.
+// Values are never assembled: each decoded run is handed to the sink as soon as it is
+// seen, so a value of any size passes through in the memory of one input piece.
+//
+//     sink(key, piece, false)  for each decoded run of the value of `key`
+//     sink(key, {}, true)      once the value's closing quote is reached
+//
+// Escapes, \u sequences and surrogate pairs are decoded to UTF-8 (a lone surrogate
+// becomes U+FFFD). Values other than strings, and keys over MAX_KEY bytes, are errors.
+class JsonStringObject {
+public:
+    enum class Status { Incomplete, Complete, Error };
+
+    static constexpr size_t MAX_KEY = 256;
+
+    template <typename Sink>
+    Status feed(std::string_view input, Sink&& sink) {
+        size_t i = 0;
+        while (i < input.size()) {
+            char c = input[i];
+            switch (state) {
+            case State::Start:
+                if (isSpace(c)) break;
+                if (c != '{') return fail();
+                state = State::KeyOrEnd;
+                break;
+
+            case State::KeyOrEnd:
+            case State::KeyStart:
+                if (isSpace(c)) break;
+                if (c == '}' && state == State::KeyOrEnd) {
+                    state = State::Done;
+                    break;
+                }
+                if (c != '"') return fail();
+                key.clear();
+                state = State::Key;
+                break;
+
+            case State::Key: {
+                bool closed = false;
+                bool ok = decodeString(input, i, closed, [this](std::string_view piece) {
+                    key.append(piece);
+                    return key.size() <= MAX_KEY;
+                });
+                if (!ok) return fail();
+                if (closed) state = State::Colon;
+                continue; // decodeString advanced i
+            }
+
+            case State::Colon:
+                if (isSpace(c)) break;
+                if (c != ':') return fail();
+                state = State::Value;
+                break;
+
+            case State::Value:
+                if (isSpace(c)) break;
+                if (c != '"') return fail();
+                state = State::ValueString;
+                break;
+
+            case State::ValueString: {
+                bool closed = false;
+                bool ok = decodeString(input, i, closed, [this, &sink](std::string_view piece) {
+                    sink(std::string_view(key), piece, false);
+                    return true;
+                });
+                if (!ok) return fail();
+                if (closed) {
+                    sink(std::string_view(key), std::string_view(), true);
+                    state = State::CommaOrEnd;
+                }
+                continue;
+            }
+
+            case State::CommaOrEnd:
+                if (isSpace(c)) break;
+                if (c == ',') state = State::KeyStart;
+                else if (c == '}') state = State::Done;
+                else return fail();
+                break;
+
+            case State::Done:
+                if (!isSpace(c)) return fail();
+                break;
+
+            case State::Failed:
+                return Status::Error;
+            }
+            i++;
+        }
+        if (state == State::Failed) return Status::Error;
+        return state == State::Done ? Status::Complete : Status::Incomplete;
+    }
+
+    bool complete() const { return state == State::Done; }
+
+private:
+    enum class State { Start, KeyOrEnd, KeyStart, Key, Colon, Value, ValueString, CommaOrEnd, Done, Failed };
+
+    State state = State::Start;
+    std::string key;
+    // Escape in progress inside a string, possibly split across feeds
+    bool escaped = false;
+    int hexDigits = -1;        // -1: not in a \u sequence, else digits read so far
+    uint32_t unit = 0;         // the \u code unit being read
+    uint32_t highSurrogate = 0;
+
+    Status fail() {
+        state = State::Failed;
+        return Status::Error;
+    }
+
+    static bool isSpace(char c) { return c == ' ' || c == '\t' || c == '\n' || c == '\r'; }
+
+    // Decode string contents from input[i] on, passing runs to emit (which returns false to
+    // abort); stops after the closing quote (closed = true) or at the end of the input
+    template <typename Emit>
+    bool decodeString(std::string_view input, size_t& i, bool& closed, Emit&& emit) {
+        while (i < input.size()) {
+            if (hexDigits >= 0) {
+                int value = hexValue(input[i++]);
+                if (value < 0) return false;
+                unit = (unit << 4) | (uint32_t)value;
+                if (++hexDigits < 4) continue;
+                hexDigits = -1;
+                if (!codeUnit(unit, emit)) return false;
+                continue;
+            }
+            if (escaped) {
+                escaped = false;
+                char c = input[i++];
+                if (c == 'u') {
+                    hexDigits = 0;
+                    unit = 0;
+                    continue;
+                }
+                char decoded;
+                switch (c) {
+                case '"': decoded = '"'; break;
+                case '\\': decoded = '\\'; break;
+                case '/': decoded = '/'; break;
+                case 'b': decoded = '\b'; break;
+                case 'f': decoded = '\f'; break;
+                case 'n': decoded = '\n'; break;
+                case 'r': decoded = '\r'; break;
+                case 't': decoded = '\t'; break;
+                default: return false;
+                }
+                if (!flushSurrogate(emit) || !emit(std::string_view(&decoded, 1))) return false;
+                continue;
+            }
+
+            // Plain run up to the next quote, backslash or control character
+            size_t end = i;
+            while (end < input.size() && input[end] != '"' && input[end] != '\\' && (unsigned char)input[end] >= 0x20) {
+                end++;
+            }
+            if (end > i) {
+                if (!flushSurrogate(emit) || !emit(input.substr(i, end - i))) return false;
+                i = end;
+            }
+            if (i == input.size()) break;
+
+            char c = input[i++];
+            if (c == '\\') {
+                escaped = true;
+            } else if (c == '"') {
+                if (!flushSurrogate(emit)) return false;
+                closed = true;
+                return true;
+            } else {
+                return false; // unescaped control character
+            }
+        }
+        return true;
+    }
+
+    static int hexValue(char c) {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        return -1;
+    }
+
+    template <typename Emit>
+    bool codeUnit(uint32_t value, Emit& emit) {
+        if (value >= 0xD800 && value <= 0xDBFF) {
+            if (!flushSurrogate(emit)) return false;
+            highSurrogate = value;
+            return true;
+        }
+        if (value >= 0xDC00 && value <= 0xDFFF) {
+            if (!highSurrogate) return codePoint(0xFFFD, emit);
+            uint32_t combined = 0x10000 + ((highSurrogate - 0xD800) << 10) + (value - 0xDC00);
+            highSurrogate = 0;
+            return codePoint(combined, emit);
+        }
+        return flushSurrogate(emit) && codePoint(value, emit);
+    }
+
+    // A high surrogate not followed by a low one
+    template <typename Emit>
+    bool flushSurrogate(Emit& emit) {
+        if (!highSurrogate) return true;
+        highSurrogate = 0;
+        return codePoint(0xFFFD, emit);
+    }
+
+    template <typename Emit>
+    static bool codePoint(uint32_t value, Emit& emit) {
+        char utf8[4];
+        size_t length;
+        if (value < 0x80) {
+            utf8[0] = (char)value;
+            length = 1;
+        } else if (value < 0x800) {
+            utf8[0] = (char)(0xC0 | (value >> 6));
+            utf8[1] = (char)(0x80 | (value & 0x3F));
+            length = 2;
+        } else if (value < 0x10000) {
+            utf8[0] = (char)(0xE0 | (value >> 12));
+            utf8[1] = (char)(0x80 | ((value >> 6) & 0x3F));
+            utf8[2] = (char)(0x80 | (value & 0x3F));
+            length = 3;
+        } else {
+            utf8[0] = (char)(0xF0 | (value >> 18));
+            utf8[1] = (char)(0x80 | ((value >> 12) & 0x3F));
+            utf8[2] = (char)(0x80 | ((value >> 6) & 0x3F));
+            utf8[3] = (char)(0x80 | (value & 0x3F));
+            length = 4;
+        }
+        return emit(std::string_view(utf8, length));
+    }
+};
+
+#endif // JSON_STREAM_H
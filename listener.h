@@ -0,0 +1,121 @@
+#ifndef LISTENER_H
+#define LISTENER_H
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <pthread.h>
+#include <sched.h>
+#include <string>
+#include <thread>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+// Listening socket setup shared by the servers. With reusePort every listener
+// binds the same port and the kernel spreads incoming connections across them,
+// so each one can be drained by its own accept thread or event loop.
+class Listener {
+public:
+    static int open(int port, int backlog, bool reusePort) {
+        int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd < 0) {
+            std::cerr << "Socket creation failed: " << errno << std::endl;
+            return -1;
+        }
+
+        int opt = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+        if (reusePort && setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &opt, sizeof(opt)) < 0) {
+            std::cerr << "SO_REUSEPORT failed: " << errno << std::endl;
+            close(fd);
+            return -1;
+        }
+
+        sockaddr_in serverAddr{};
+        serverAddr.sin_family = AF_INET;
+        serverAddr.sin_addr.s_addr = INADDR_ANY;
+        serverAddr.sin_port = htons(port);
+
+        if (bind(fd, (sockaddr*)&serverAddr, sizeof(serverAddr)) < 0) {
+            std::cerr << "Bind failed: " << errno << std::endl;
+            close(fd);
+            return -1;
+        }
+
+        if (listen(fd, backlog) < 0) {
+            std::cerr << "Listen failed: " << errno << std::endl;
+            close(fd);
+            return -1;
+        }
+        return fd;
+    }
+
+    // Pin the calling thread to one core (wrapping around the online core count)
+    static bool pinCurrentThread(int index) {
+        unsigned cores = std::thread::hardware_concurrency();
+        if (cores == 0) return false;
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(index % cores, &set);
+        return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+    }
+};
+
+// Accept counters for one listener. record() is called by the single thread
+// draining the listener; readers on other threads only load the atomics.
+class AcceptStats {
+public:
+    AcceptStats() : accepted(0), windowSecond(0), windowCount(0), previousWindowCount(0) {}
+
+    void record() {
+        int64_t second = nowSeconds();
+        if (second != windowSecond.load(std::memory_order_relaxed)) {
+            bool adjacent = second == windowSecond.load(std::memory_order_relaxed) + 1;
+            previousWindowCount.store(adjacent ? windowCount.load(std::memory_order_relaxed) : 0,
+                                      std::memory_order_relaxed);
+            windowCount.store(0, std::memory_order_relaxed);
+            windowSecond.store(second, std::memory_order_relaxed);
+        }
+        windowCount.fetch_add(1, std::memory_order_relaxed);
+        accepted.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    uint64_t total() const { return accepted.load(std::memory_order_relaxed); }
+
+    // Connections accepted during the last complete second
+    uint64_t lastSecond() const {
+        int64_t second = nowSeconds();
+        int64_t window = windowSecond.load(std::memory_order_relaxed);
+        if (second == window) return previousWindowCount.load(std::memory_order_relaxed);
+        if (second == window + 1) return windowCount.load(std::memory_order_relaxed);
+        return 0;
+    }
+
+    // JSON object for one acceptor draining listener `listener`
+    std::string toJson(int listener, double uptimeSeconds) const {
+        double average = uptimeSeconds > 0 ? total() / uptimeSeconds : 0.0;
+        char buffer[192];
+        snprintf(buffer, sizeof(buffer),
+                 "{\"listener\":%d,\"accepted\":%llu,\"accepts_per_sec\":%llu,\"avg_accepts_per_sec\":%.2f}",
+                 listener, (unsigned long long)total(), (unsigned long long)lastSecond(), average);
+        return buffer;
+    }
+
+private:
+    std::atomic<uint64_t> accepted;
+    std::atomic<int64_t> windowSecond;
+    std::atomic<uint64_t> windowCount;
+    std::atomic<uint64_t> previousWindowCount;
+
+    static int64_t nowSeconds() {
+        return std::chrono::duration_cast<std::chrono::seconds>(
+                   std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+};
+
+#endif // LISTENER_H
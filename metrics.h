@@ -0,0 +1,175 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Request counters and latency histograms per route and status, in Prometheus text format.
+// Every thread records into its own shard, so the hot path is a few relaxed
+// increments on cache lines no other writer touches; a scrape sums the shards
+// without stopping anyone.
+class RequestMetrics {
+public:
+    // Upper bounds of the latency buckets, in seconds
+    static constexpr double BUCKETS[] = {0.0001, 0.00025, 0.0005, 0.001, 0.0025, 0.005,
+                                         0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1, 2.5};
+    static constexpr size_t BUCKET_COUNT = sizeof(BUCKETS) / sizeof(BUCKETS[0]) + 1; // + Inf
+
+    // Status codes counted individually; anything else is counted under its class
+    // ("1xx" to "5xx"), which still matches patterns such as status_code=~"5.."
+    static constexpr int STATUSES[] = {200, 206, 304, 400, 403, 404, 405, 408, 413, 416, 431, 500, 503};
+    static constexpr size_t CODE_COUNT = sizeof(STATUSES) / sizeof(STATUSES[0]);
+    static constexpr size_t STATUS_COUNT = CODE_COUNT + 5;
+
+    explicit RequestMetrics(std::vector<std::string> routeNames) : routes(std::move(routeNames)) {}
+
+    RequestMetrics(const RequestMetrics&) = delete;
+    RequestMetrics& operator=(const RequestMetrics&) = delete;
+
+    size_t routeCount() const { return routes.size(); }
+
+    void record(size_t route, int status, uint64_t micros, size_t bytes) {
+        if (route >= routes.size()) return;
+        Shard& shard = threadShard();
+        size_t series = route * STATUS_COUNT + statusIndex(status);
+        bump(shard.requests[series]);
+        bump(shard.buckets[series * BUCKET_COUNT + bucketIndex(micros)]);
+        add(shard.latencyMicros[series], micros);
+        add(shard.bytesSent, bytes);
+    }
+
+    // http_requests_total, http_request_duration_seconds and http_response_bytes_total
+    void render(std::string& out) const {
+        std::vector<uint64_t> requests(routes.size() * STATUS_COUNT);
+        std::vector<uint64_t> buckets(routes.size() * STATUS_COUNT * BUCKET_COUNT);
+        std::vector<uint64_t> latency(routes.size() * STATUS_COUNT);
+        uint64_t bytes = 0;
+        {
+            std::lock_guard<std::mutex> lock(shardsMutex);
+            for (const auto& shard : shards) {
+                for (size_t i = 0; i < requests.size(); i++) requests[i] += load(shard->requests[i]);
+                for (size_t i = 0; i < buckets.size(); i++) buckets[i] += load(shard->buckets[i]);
+                for (size_t i = 0; i < latency.size(); i++) latency[i] += load(shard->latencyMicros[i]);
+                bytes += load(shard->bytesSent);
+            }
+        }
+
+        out += "# HELP http_requests_total Requests answered, by route and status code.\n"
+               "# TYPE http_requests_total counter\n";
+        for (size_t route = 0; route < routes.size(); route++) {
+            for (size_t status = 0; status < STATUS_COUNT; status++) {
+                uint64_t count = requests[route * STATUS_COUNT + status];
+                if (count == 0) continue;
+                out += "http_requests_total{" + labels(route, status) + "} " + std::to_string(count) + "\n";
+            }
+        }
+
+        out += "# HELP http_request_duration_seconds Time from a parsed request to its queued response.\n"
+               "# TYPE http_request_duration_seconds histogram\n";
+        for (size_t series = 0; series < latency.size(); series++) {
+            if (requests[series] == 0) continue;
+            std::string seriesLabels = labels(series / STATUS_COUNT, series % STATUS_COUNT);
+            uint64_t cumulative = 0;
+            for (size_t bucket = 0; bucket < BUCKET_COUNT; bucket++) {
+                cumulative += buckets[series * BUCKET_COUNT + bucket];
+                out += "http_request_duration_seconds_bucket{" + seriesLabels + ",le=\"" +
+                       (bucket < BUCKET_COUNT - 1 ? formatNumber(BUCKETS[bucket]) : std::string("+Inf")) +
+                       "\"} " + std::to_string(cumulative) + "\n";
+            }
+            out += "http_request_duration_seconds_sum{" + seriesLabels + "} " + formatNumber(latency[series] / 1e6) + "\n";
+            out += "http_request_duration_seconds_count{" + seriesLabels + "} " + std::to_string(cumulative) + "\n";
+        }
+
+        out += "# HELP http_response_bytes_total Response bytes queued for clients, headers included.\n"
+               "# TYPE http_response_bytes_total counter\n"
+               "http_response_bytes_total " + std::to_string(bytes) + "\n";
+    }
+
+    // One metric family with a single unlabelled sample
+    static void renderSample(std::string& out, std::string_view name, std::string_view type,
+                             std::string_view help, double value) {
+        out.append("# HELP ").append(name).append(" ").append(help).append("\n");
+        out.append("# TYPE ").append(name).append(" ").append(type).append("\n");
+        out.append(name).append(" ").append(formatNumber(value)).append("\n");
+    }
+
+    // Whole numbers (counters, gauges) exactly; fractions to six significant digits
+    static std::string formatNumber(double value) {
+        char text[32];
+        if (value > -1e15 && value < 1e15 && value == (double)(int64_t)value) {
+            snprintf(text, sizeof(text), "%lld", (long long)value);
+        } else {
+            snprintf(text, sizeof(text), "%.6g", value);
+        }
+        return text;
+    }
+
+private:
+    // Counters written only by the owning thread; atomics so scrapes read whole values
+    struct Shard {
+        explicit Shard(size_t routeCount)
+            : requests(new std::atomic<uint64_t>[routeCount * STATUS_COUNT]()),
+              buckets(new std::atomic<uint64_t>[routeCount * STATUS_COUNT * BUCKET_COUNT]()),
+              latencyMicros(new std::atomic<uint64_t>[routeCount * STATUS_COUNT]()),
+              bytesSent(0) {}
+
+        std::unique_ptr<std::atomic<uint64_t>[]> requests;
+        std::unique_ptr<std::atomic<uint64_t>[]> buckets;
+        std::unique_ptr<std::atomic<uint64_t>[]> latencyMicros;
+        alignas(64) std::atomic<uint64_t> bytesSent;
+    };
+
+    std::vector<std::string> routes;
+    mutable std::mutex shardsMutex;
+    std::vector<std::unique_ptr<Shard>> shards; // kept after their thread exits so counts persist
+
+    // Single writer per shard: a relaxed load and store, no locked read-modify-write
+    static void add(std::atomic<uint64_t>& counter, uint64_t amount) {
+        counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+    static void bump(std::atomic<uint64_t>& counter) { add(counter, 1); }
+    static uint64_t load(const std::atomic<uint64_t>& counter) { return counter.load(std::memory_order_relaxed); }
+
+    Shard& threadShard() {
+        thread_local const RequestMetrics* owner = nullptr;
+        thread_local Shard* shard = nullptr;
+        if (owner != this) {
+            auto created = std::make_unique<Shard>(routes.size());
+            shard = created.get();
+            owner = this;
+            std::lock_guard<std::mutex> lock(shardsMutex);
+            shards.push_back(std::move(created));
+        }
+        return *shard;
+    }
+
+    static size_t statusIndex(int status) {
+        for (size_t i = 0; i < CODE_COUNT; i++) {
+            if (STATUSES[i] == status) return i;
+        }
+        int statusClass = status / 100;
+        return CODE_COUNT + (statusClass < 1 ? 0 : statusClass > 5 ? 4 : statusClass - 1);
+    }
+
+    std::string labels(size_t route, size_t status) const {
+        std::string code = status < CODE_COUNT ? std::to_string(STATUSES[status])
+                                               : std::to_string(status - CODE_COUNT + 1) + "xx";
+        return "route=\"" + routes[route] + "\",status_code=\"" + code + "\"";
+    }
+
+    static size_t bucketIndex(uint64_t micros) {
+        double seconds = micros / 1e6;
+        for (size_t i = 0; i < BUCKET_COUNT - 1; i++) {
+            if (seconds <= BUCKETS[i]) return i;
+        }
+        return BUCKET_COUNT - 1;
+    }
+};
+
+#endif // METRICS_H
@@ -0,0 +1,38 @@
+#ifndef PAGE_FINGERPRINT_H
+#define PAGE_FINGERPRINT_H
+
+#include <ctime>
+#include <string>
+#include "trace.h"
+
+// The tally fingerprint on served HTML: a hash of the page, spliced in as a comment just
+// past the <body ...> tag. Pages without a <body> tag go out unchanged.
+
+// Offset just past the <body ...> tag, npos if there is none
+inline size_t fingerprintSplice(const std::string& content) {
+    size_t bodyPos = content.find("<body");
+    if (bodyPos == std::string::npos) return std::string::npos;
+    size_t bodyEnd = content.find(">", bodyPos);
+    return bodyEnd == std::string::npos ? std::string::npos : bodyEnd + 1;
+}
+
+// The comment spliced in for `fingerprint`
+inline std::string fingerprintComment(const std::string& fingerprint) {
+    return "\n<!-- TALLY FINGERPRINT: " + fingerprint + " -->\n"
+           "<!-- SERVED BY: Economic Justice Tally Network -->\n";
+}
+
+// `content` fingerprinted with hash(content + path + current time), where `hash` maps a
+// string to its hex digest
+template <typename Hash>
+std::string fingerprintContent(const std::string& content, const std::string& path, Hash&& hash) {
+    TraceSpan span("fingerprintContent");
+    std::string fingerprintedContent = content;
+    size_t splice = fingerprintSplice(content);
+    if (splice != std::string::npos) {
+        fingerprintedContent.insert(splice, fingerprintComment(hash(content + path + std::to_string(time(nullptr)))));
+    }
+    return fingerprintedContent;
+}
+
+#endif // PAGE_FINGERPRINT_H
@@ -0,0 +1,48 @@
+#ifndef REQUEST_ARENA_H
+#define REQUEST_ARENA_H
+
+#include <charconv>
+#include <cstddef>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+
+using ArenaString = std::pmr::string;
+
+// Monotonic bump allocator for the scratch strings one request builds (paths, JSON
+// bodies). Allocation is a pointer bump inside an inline buffer owned by the
+// connection; only a request that outgrows it touches malloc. reset() rewinds to the
+// start of the buffer, so the whole request is freed at once when it completes.
+// Nothing allocated here may outlive the request: response bodies are copied or moved
+// onto the send queue before reset().
+class RequestArena {
+public:
+    static constexpr size_t INLINE_BYTES = 8 * 1024;
+
+    RequestArena() : resource(buffer, sizeof(buffer), std::pmr::new_delete_resource()) {}
+
+    RequestArena(const RequestArena&) = delete;
+    RequestArena& operator=(const RequestArena&) = delete;
+
+    ArenaString string(std::string_view initial = "") { return ArenaString(initial, &resource); }
+
+    std::pmr::memory_resource* memory() { return &resource; }
+
+    // O(1) unless the request spilled into heap chunks, which are returned here
+    void reset() { resource.release(); }
+
+private:
+    alignas(std::max_align_t) std::byte buffer[INLINE_BYTES];
+    std::pmr::monotonic_buffer_resource resource;
+};
+
+// Append a number without the temporary std::to_string would allocate
+template <typename Number>
+inline ArenaString& appendNumber(ArenaString& out, Number value) {
+    char digits[24];
+    auto result = std::to_chars(digits, digits + sizeof(digits), value);
+    out.append(digits, result.ptr - digits);
+    return out;
+}
+
+#endif // REQUEST_ARENA_H
@@ -0,0 +1,89 @@
+#ifndef RESPONSE_WRITER_H
+#define RESPONSE_WRITER_H
+
+#include <charconv>
+#include <cstdint>
+#include <poll.h>
+#include <string_view>
+#include "send-queue.h"
+
+// Formats an HTTP/1.1 status line and headers straight into a SendQueue. Pieces are
+// appended to the queue's tail buffer, which the queue recycles once sent, so a
+// connection that reuses its queue formats heads without allocating. Bodies are
+// queued after end() with the SendQueue append calls (owned, shared, borrowed or file).
+class ResponseWriter {
+public:
+    // `statusCode`, when given, receives the code of the status line written (for logs and metrics)
+    explicit ResponseWriter(SendQueue& queue, int* statusCode = nullptr) : queue(queue), statusCode(statusCode) {}
+
+    // `status` is the code and reason together, e.g. "200 OK"
+    ResponseWriter& status(std::string_view status) {
+        if (statusCode) std::from_chars(status.data(), status.data() + status.size(), *statusCode);
+        queue.append("HTTP/1.1 ");
+        queue.append(status);
+        queue.append("\r\n");
+        return *this;
+    }
+
+    ResponseWriter& status(int code, std::string_view reason) {
+        if (statusCode) *statusCode = code;
+        queue.append("HTTP/1.1 ");
+        appendNumber(code);
+        queue.append(" ");
+        queue.append(reason);
+        queue.append("\r\n");
+        return *this;
+    }
+
+    ResponseWriter& header(std::string_view name, std::string_view value) {
+        queue.append(name);
+        queue.append(": ");
+        queue.append(value);
+        queue.append("\r\n");
+        return *this;
+    }
+
+    ResponseWriter& header(std::string_view name, uint64_t value) {
+        queue.append(name);
+        queue.append(": ");
+        appendNumber(value);
+        queue.append("\r\n");
+        return *this;
+    }
+
+    // Already formatted "Name: value\r\n" lines, e.g. cached validators
+    ResponseWriter& headers(std::string_view lines) {
+        queue.append(lines);
+        return *this;
+    }
+
+    // Close the header block; the body, if any, is queued next
+    void end() { queue.append("\r\n"); }
+
+    // Drain `queue` to a socket, waiting up to timeoutMs for it to become writable whenever
+    // it is non-blocking and full. Partial writes resume where they stopped.
+    static bool flush(SendQueue& queue, int socket, int timeoutMs = 30000) {
+        while (true) {
+            SendQueue::Result result = queue.writeTo(socket);
+            if (result == SendQueue::Result::Done) return true;
+            if (result == SendQueue::Result::Error) break;
+            pollfd writable{socket, POLLOUT, 0};
+            if (poll(&writable, 1, timeoutMs) <= 0) break;
+        }
+        queue.clear();
+        return false;
+    }
+
+private:
+    SendQueue& queue;
+    int* statusCode;
+
+    template <typename Number>
+    void appendNumber(Number value) {
+        char digits[24];
+        auto result = std::to_chars(digits, digits + sizeof(digits), value);
+        queue.append(std::string_view(digits, result.ptr - digits));
+    }
+};
+
+#endif // RESPONSE_WRITER_H
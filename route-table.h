@@ -0,0 +1,144 @@
+#ifndef ROUTE_TABLE_H
+#define ROUTE_TABLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// Method bits so one route can accept several methods
+enum RouteMethod : uint8_t {
+    ROUTE_GET = 1,
+    ROUTE_HEAD = 2,
+    ROUTE_POST = 4,
+    ROUTE_PUT = 8,
+    ROUTE_DELETE = 16,
+};
+
+// One registered route. A pattern is either an exact path or a prefix ending in a
+// single parameter segment, e.g. "/api/network/send/{id}".
+struct RouteSpec {
+    uint8_t methods = 0;
+    std::string_view pattern;
+    int id = -1;
+};
+
+struct RouteMatch {
+    int id = -1;                 // -1: no route has this path
+    bool methodAllowed = false;
+    uint8_t allowedMethods = 0;  // for the Allow header of a 405
+    std::string_view param;      // value of the {parameter} segment, if any
+
+    bool found() const { return id >= 0; }
+};
+
+// Route registry built entirely at compile time: exact paths go into a perfect
+// hash (the constructor searches for a collision-free seed), parameter routes are
+// checked by prefix only when the hash misses. A lookup hashes the path once and
+// does at most one full string comparison per candidate.
+template <size_t N>
+class RouteTable {
+public:
+    constexpr explicit RouteTable(const RouteSpec (&specs)[N])
+        : routes{}, prefixLengths{}, slots{}, prefixRoutes{}, prefixCount(0), seed(0) {
+        for (size_t i = 0; i < N; i++) {
+            routes[i] = specs[i];
+            size_t brace = specs[i].pattern.find('{');
+            prefixLengths[i] = brace == std::string_view::npos ? 0 : brace;
+            if (brace != std::string_view::npos) prefixRoutes[prefixCount++] = i;
+        }
+        for (uint32_t candidate = 1; candidate < 100000; candidate++) {
+            if (tryBuild(candidate)) {
+                seed = candidate;
+                return;
+            }
+        }
+    }
+
+    // False if no perfect hash seed was found (or two routes share a path)
+    constexpr bool valid() const { return seed != 0; }
+
+    constexpr RouteMatch match(std::string_view method, std::string_view path) const {
+        uint8_t bit = methodBit(method);
+        int index = slots[hash(path, seed) & (SLOT_COUNT - 1)];
+        if (index >= 0 && routes[index].pattern == path) {
+            return result(index, bit, std::string_view());
+        }
+        for (size_t i = 0; i < prefixCount; i++) {
+            size_t route = prefixRoutes[i];
+            size_t length = prefixLengths[route];
+            if (path.size() > length && path.substr(0, length) == routes[route].pattern.substr(0, length) &&
+                path.find('/', length) == std::string_view::npos) {
+                return result((int)route, bit, path.substr(length));
+            }
+        }
+        return RouteMatch();
+    }
+
+    static constexpr uint8_t methodBit(std::string_view method) {
+        if (method == "GET") return ROUTE_GET;
+        if (method == "HEAD") return ROUTE_HEAD;
+        if (method == "POST") return ROUTE_POST;
+        if (method == "PUT") return ROUTE_PUT;
+        if (method == "DELETE") return ROUTE_DELETE;
+        return 0;
+    }
+
+    static std::string allowHeader(uint8_t methods) {
+        static const char* names[] = {"GET", "HEAD", "POST", "PUT", "DELETE"};
+        std::string allow;
+        for (int bit = 0; bit < 5; bit++) {
+            if (!(methods & (1 << bit))) continue;
+            if (!allow.empty()) allow += ", ";
+            allow += names[bit];
+        }
+        return allow;
+    }
+
+private:
+    static constexpr size_t slotCountFor(size_t routeCount) {
+        size_t count = 8;
+        while (count < routeCount * 2) count *= 2;
+        return count;
+    }
+    static constexpr size_t SLOT_COUNT = slotCountFor(N);
+
+    RouteSpec routes[N];
+    size_t prefixLengths[N];     // parameter routes: length of the literal prefix
+    int slots[SLOT_COUNT];       // perfect hash of exact paths, -1 when empty
+    size_t prefixRoutes[N];
+    size_t prefixCount;
+    uint32_t seed;
+
+    // FNV-1a with a seeded offset basis
+    static constexpr uint32_t hash(std::string_view text, uint32_t seed) {
+        uint32_t h = 2166136261u ^ (seed * 0x9e3779b9u);
+        for (char c : text) {
+            h ^= (uint8_t)c;
+            h *= 16777619u;
+        }
+        return h;
+    }
+
+    constexpr bool tryBuild(uint32_t candidate) {
+        for (size_t i = 0; i < SLOT_COUNT; i++) slots[i] = -1;
+        for (size_t i = 0; i < N; i++) {
+            if (prefixLengths[i] != 0) continue;
+            size_t slot = hash(routes[i].pattern, candidate) & (SLOT_COUNT - 1);
+            if (slots[slot] != -1) return false;
+            slots[slot] = (int)i;
+        }
+        return true;
+    }
+
+    constexpr RouteMatch result(int index, uint8_t methodBit, std::string_view param) const {
+        RouteMatch match;
+        match.id = routes[index].id;
+        match.allowedMethods = routes[index].methods;
+        match.methodAllowed = (routes[index].methods & methodBit) != 0;
+        match.param = param;
+        return match;
+    }
+};
+
+#endif // ROUTE_TABLE_H
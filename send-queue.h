@@ -0,0 +1,245 @@
+#ifndef SEND_QUEUE_H
+#define SEND_QUEUE_H
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <sys/sendfile.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+// Ordered outgoing data for one connection: in-memory byte runs interleaved with
+// file ranges. Byte runs leave in one gather write, file ranges go through
+// sendfile(2) straight from the page cache, so file bodies never enter user space.
+// Senders must ignore SIGPIPE, since sendfile has no MSG_NOSIGNAL equivalent.
+class SendQueue {
+public:
+    enum class Result { Done, WouldBlock, Error };
+
+    SendQueue() : pending(0) {}
+    ~SendQueue() { clear(); }
+
+    SendQueue(const SendQueue&) = delete;
+    SendQueue& operator=(const SendQueue&) = delete;
+
+    // Copy small pieces (heads, short bodies) into the tail buffer, coalescing them into one iovec
+    void append(std::string_view bytes) {
+        if (bytes.empty()) return;
+        if (segments.empty() || !segments.back().owned()) {
+            segments.emplace_back();
+            if (!spare.empty()) {
+                segments.back().bytes.swap(spare.back());
+                spare.pop_back();
+            }
+        }
+        segments.back().bytes.append(bytes);
+        pending += bytes.size();
+    }
+
+    // Take over a body built by the caller without copying it
+    void appendOwned(std::string&& bytes) {
+        if (bytes.empty()) return;
+        pending += bytes.size();
+        Segment segment;
+        segment.bytes = std::move(bytes);
+        segments.push_back(std::move(segment));
+    }
+
+    // Queue bytes the caller guarantees outlive the queue (string literals, static tables)
+    void appendBorrowed(std::string_view bytes) {
+        if (bytes.empty()) return;
+        pending += bytes.size();
+        Segment segment;
+        segment.borrowed = bytes;
+        segments.push_back(std::move(segment));
+    }
+
+    // Queue an immutable buffer shared with other connections (e.g. a cached asset) without copying it
+    void append(std::shared_ptr<const std::string> buffer) {
+        if (!buffer) return;
+        size_t length = buffer->size();
+        append(std::move(buffer), 0, length);
+    }
+
+    // Queue `length` bytes of a shared buffer starting at `offset`
+    void append(std::shared_ptr<const std::string> buffer, size_t offset, size_t length) {
+        if (!buffer || length == 0) return;
+        pending += length;
+        Segment segment;
+        segment.shared = std::move(buffer);
+        segment.offset = offset;
+        segment.remaining = length;
+        segments.push_back(std::move(segment));
+    }
+
+    // Move everything queued in `other` to the end of this queue
+    void append(SendQueue&& other) {
+        for (Segment& segment : other.segments) {
+            segments.push_back(std::move(segment));
+        }
+        pending += other.pending;
+        other.segments.clear();
+        other.pending = 0;
+    }
+
+    // Queue `length` bytes of `fd` starting at `offset`; the queue closes fd when done
+    void appendFile(int fd, off_t offset, size_t length) {
+        if (length == 0) {
+            close(fd);
+            return;
+        }
+        Segment segment;
+        segment.fd = fd;
+        segment.offset = offset;
+        segment.remaining = length;
+        segments.push_back(std::move(segment));
+        pending += length;
+    }
+
+    bool empty() const { return segments.empty(); }
+    size_t pendingBytes() const { return pending; }
+
+    // Write as much as the socket takes. Blocking sockets only return Done or Error;
+    // non-blocking ones return WouldBlock once the send buffer is full.
+    Result writeTo(int socket) {
+        while (!segments.empty()) {
+            Segment& front = segments.front();
+            if (front.fd >= 0) {
+                ssize_t n = sendfile(socket, front.fd, &front.offset, front.remaining);
+                if (n > 0) {
+                    front.remaining -= n;
+                    pending -= n;
+                    if (front.remaining == 0) popFront();
+                    continue;
+                }
+                if (n < 0 && errno == EINTR) continue;
+                if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return Result::WouldBlock;
+                return Result::Error; // n == 0: the file shrank under us, the body would be short
+            }
+
+            // Gather every byte run up to the next file range into one write. MSG_MORE
+            // keeps headers in the same segment as the file body that follows them.
+            iovec iov[MAX_IOV];
+            bool fileFollows = false;
+            size_t count = gather(iov, MAX_IOV, &fileFollows);
+
+            msghdr message{};
+            message.msg_iov = iov;
+            message.msg_iovlen = count;
+            ssize_t n = sendmsg(socket, &message, MSG_NOSIGNAL | (fileFollows ? MSG_MORE : 0));
+            if (n < 0 && errno == EINTR) continue;
+            if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return Result::WouldBlock;
+            if (n <= 0) return Result::Error;
+            consume(n);
+        }
+        return Result::Done;
+    }
+
+    // Completion-based senders (io_uring) drive the queue themselves with the calls below.
+    // Nothing may be appended while a gathered write is in flight: appends can grow the
+    // tail buffer the iovecs point into.
+
+    static constexpr size_t MAX_IOV = 64; // byte runs gathered into one write
+
+    // Fill `iov` with the leading byte runs, stopping at a file range; returns the count
+    size_t gather(iovec* iov, size_t maxIov, bool* fileFollows = nullptr) const {
+        size_t count = 0;
+        if (fileFollows) *fileFollows = false;
+        for (const Segment& segment : segments) {
+            if (segment.fd >= 0) {
+                if (fileFollows) *fileFollows = true;
+                break;
+            }
+            if (count == maxIov) break;
+            std::string_view bytes = segment.data();
+            iov[count].iov_base = const_cast<char*>(bytes.data()) + segment.sent;
+            iov[count].iov_len = bytes.size() - segment.sent;
+            count++;
+        }
+        return count;
+    }
+
+    // The file range at the front of the queue, if that is what goes out next
+    bool frontFile(int* fd, off_t* offset, size_t* remaining) const {
+        if (segments.empty() || segments.front().fd < 0) return false;
+        const Segment& front = segments.front();
+        *fd = front.fd;
+        *offset = front.offset;
+        *remaining = front.remaining;
+        return true;
+    }
+
+    // Advance past `n` bytes of the front file range
+    void consumeFile(size_t n) {
+        Segment& front = segments.front();
+        front.offset += n;
+        front.remaining -= n;
+        pending -= n;
+        if (front.remaining == 0) popFront();
+    }
+
+    // Advance past `n` bytes written from the leading byte runs
+    void consume(size_t n) {
+        pending -= n;
+        while (n > 0) {
+            Segment& front = segments.front();
+            size_t size = front.data().size();
+            size_t take = std::min(n, size - front.sent);
+            front.sent += take;
+            n -= take;
+            if (front.sent == size) popFront();
+        }
+    }
+
+    void clear() {
+        while (!segments.empty()) popFront();
+        pending = 0;
+    }
+
+private:
+    static constexpr size_t MAX_SPARE = 4;              // recycled tail buffers kept per queue
+    static constexpr size_t MAX_SPARE_CAPACITY = 16384; // larger buffers go back to malloc
+
+    // Owned bytes, borrowed bytes, a slice [offset, offset + remaining) of a shared
+    // buffer, or a file range
+    struct Segment {
+        std::string bytes;
+        std::string_view borrowed;
+        std::shared_ptr<const std::string> shared;
+        size_t sent = 0;
+        int fd = -1;
+        off_t offset = 0;
+        size_t remaining = 0;
+
+        bool owned() const { return fd < 0 && !shared && borrowed.data() == nullptr; }
+
+        std::string_view data() const {
+            if (shared) return std::string_view(*shared).substr(offset, remaining);
+            if (borrowed.data()) return borrowed;
+            return bytes;
+        }
+    };
+
+    std::deque<Segment> segments;
+    std::vector<std::string> spare;
+    size_t pending;
+
+    void popFront() {
+        Segment& front = segments.front();
+        if (front.fd >= 0) close(front.fd);
+        if (front.owned() && spare.size() < MAX_SPARE && front.bytes.capacity() <= MAX_SPARE_CAPACITY) {
+            front.bytes.clear();
+            spare.push_back(std::move(front.bytes));
+        }
+        segments.pop_front();
+    }
+};
+
+#endif // SEND_QUEUE_H
@@ -0,0 +1,451 @@
+#ifndef STATIC_CACHE_H
+#define STATIC_CACHE_H
+
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <iostream>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "compression.h"
+#include "conditional.h"
+
+// One encoding of a cached file and the entity headers that describe it
+struct AssetBody {
+    std::shared_ptr<const std::string> bytes;
+    std::string headers;    // Content-Type, Content-Length, Accept-Ranges and, when encoded, Content-Encoding
+    std::string etag;
+    std::string validators; // ETag, Last-Modified and Vary; also sent on 304
+};
+
+// One static file as last seen on disk. Files above the per-entry limit keep only
+// their metadata and are streamed with sendfile; identity.bytes is null for those.
+// Compressible files also keep gzip/deflate variants when those are smaller. Each
+// body gets its own strong ETag; HTML, rewritten per response, only a weak one.
+struct CachedAsset {
+    std::string fullPath;
+    std::string contentType;
+    size_t size = 0;
+    timespec mtime{};
+    AssetBody identity;
+    AssetBody gzip;
+    AssetBody deflate;
+
+    bool isHtml() const { return contentType == "text/html"; }
+
+    // Smallest stored body the client accepts
+    const AssetBody& bodyFor(ContentCoding coding) const {
+        if (coding == ContentCoding::Gzip && gzip.bytes) return gzip;
+        if (coding == ContentCoding::Deflate && deflate.bytes) return deflate;
+        return identity;
+    }
+};
+
+// Sharded LRU cache of static files keyed by normalized path. Entries are filled
+// on first access (or by warm()), bounded by a total memory cap, and dropped by an
+// inotify watcher thread as soon as the file or its directory changes.
+class StaticAssetCache {
+public:
+    // precompressLevel > 0 stores gzip and deflate variants of compressible files at that zlib level
+    StaticAssetCache(const std::string& rootDir, size_t capacityBytes, int precompressLevel = 9)
+        : rootDir(rootDir), capacity(capacityBytes), maxEntryBytes(capacityBytes / SHARD_COUNT / 2),
+          precompressLevel(precompressLevel),
+          hitCount(0), missCount(0), evictionCount(0), invalidationCount(0),
+          inotifyFd(-1), wakeFd(-1), watching(false) {}
+
+    ~StaticAssetCache() {
+        stopWatcher();
+    }
+
+    StaticAssetCache(const StaticAssetCache&) = delete;
+    StaticAssetCache& operator=(const StaticAssetCache&) = delete;
+
+    static std::string contentTypeFor(const std::string& extension) {
+        if (extension == ".html") return "text/html";
+        if (extension == ".css") return "text/css";
+        if (extension == ".js") return "application/javascript";
+        if (extension == ".json") return "application/json";
+        if (extension == ".png") return "image/png";
+        if (extension == ".jpg" || extension == ".jpeg") return "image/jpeg";
+        if (extension == ".gif") return "image/gif";
+        if (extension == ".svg") return "image/svg+xml";
+        return "text/plain";
+    }
+
+    // Cached entry for fullPath, loading it on a miss; null if it is not a regular file
+    std::shared_ptr<const CachedAsset> lookup(std::string_view fullPath) {
+        // Reused by each thread, so a hit on an already-normal path never allocates
+        static thread_local std::string key;
+        normalizeInto(fullPath, key);
+        Shard& shard = shardFor(key);
+        uint64_t generation;
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            auto it = shard.entries.find(key);
+            if (it != shard.entries.end()) {
+                shard.lru.splice(shard.lru.begin(), shard.lru, it->second.position);
+                hitCount.fetch_add(1, std::memory_order_relaxed);
+                return it->second.asset;
+            }
+            generation = shard.generation;
+        }
+
+        missCount.fetch_add(1, std::memory_order_relaxed);
+        std::shared_ptr<const CachedAsset> asset = load(std::string(fullPath));
+        if (asset && capacity > 0) insert(shard, key, asset, generation);
+        return asset;
+    }
+
+    // Load every file under the root, skipping hidden directories, until the cache is full
+    void warm() {
+        if (capacity == 0) return;
+        std::error_code error;
+        std::filesystem::recursive_directory_iterator it(rootDir, std::filesystem::directory_options::skip_permission_denied, error);
+        for (; !error && it != std::filesystem::recursive_directory_iterator(); it.increment(error)) {
+            std::string name = it->path().filename().string();
+            if (it->is_directory(error)) {
+                if (!name.empty() && name[0] == '.') it.disable_recursion_pending();
+                continue;
+            }
+            if (!it->is_regular_file(error)) continue;
+            if (bytesUsed() + it->file_size(error) > capacity) continue;
+            lookup(it->path().string());
+        }
+    }
+
+    // Watch the root and every directory below it; changes invalidate cached entries
+    bool startWatcher() {
+        if (watching) return true;
+        inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (inotifyFd < 0 || wakeFd < 0) {
+            std::cerr << "⚠️  inotify unavailable, static cache will not see file changes: " << errno << std::endl;
+            closeWatcherFds();
+            return false;
+        }
+        watchTree(rootDir);
+        watching = true;
+        watcher = std::thread(&StaticAssetCache::watchLoop, this);
+        return true;
+    }
+
+    void stopWatcher() {
+        if (!watching) return;
+        watching = false;
+        uint64_t one = 1;
+        ssize_t ignored = write(wakeFd, &one, sizeof(one));
+        (void)ignored;
+        if (watcher.joinable()) watcher.join();
+        closeWatcherFds();
+    }
+
+    void invalidate(const std::string& fullPath) {
+        std::string key = normalize(fullPath);
+        Shard& shard = shardFor(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.generation++;
+        auto it = shard.entries.find(key);
+        if (it == shard.entries.end()) return;
+        removeEntry(shard, it);
+        invalidationCount.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void clear() {
+        for (Shard& shard : shards) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            shard.generation++;
+            invalidationCount.fetch_add(shard.entries.size(), std::memory_order_relaxed);
+            shard.entries.clear();
+            shard.lru.clear();
+            shard.bytes = 0;
+        }
+    }
+
+    uint64_t hits() const { return hitCount.load(std::memory_order_relaxed); }
+    uint64_t misses() const { return missCount.load(std::memory_order_relaxed); }
+
+    size_t bytesUsed() const {
+        size_t total = 0;
+        for (const Shard& shard : shards) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            total += shard.bytes;
+        }
+        return total;
+    }
+
+    size_t entryCount() const {
+        size_t total = 0;
+        for (const Shard& shard : shards) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            total += shard.entries.size();
+        }
+        return total;
+    }
+
+    std::string toJson() const {
+        return "{\"entries\":" + std::to_string(entryCount()) +
+               ",\"bytes\":" + std::to_string(bytesUsed()) +
+               ",\"capacity\":" + std::to_string(capacity) +
+               ",\"hits\":" + std::to_string(hits()) +
+               ",\"misses\":" + std::to_string(misses()) +
+               ",\"evictions\":" + std::to_string(evictionCount.load(std::memory_order_relaxed)) +
+               ",\"invalidations\":" + std::to_string(invalidationCount.load(std::memory_order_relaxed)) +
+               ",\"watching\":" + (watching ? "true" : "false") + "}";
+    }
+
+private:
+    static constexpr size_t SHARD_COUNT = 16;
+    // Approximate bookkeeping cost charged for every entry on top of its bytes
+    static constexpr size_t ENTRY_OVERHEAD = 256;
+
+    struct Entry {
+        std::shared_ptr<const CachedAsset> asset;
+        std::list<std::string>::iterator position;
+        size_t cost;
+    };
+
+    struct Shard {
+        mutable std::mutex mutex;
+        std::unordered_map<std::string, Entry> entries;
+        std::list<std::string> lru; // most recently used first
+        size_t bytes = 0;
+        uint64_t generation = 0;    // bumped by every invalidation, so a load racing one is not cached
+    };
+
+    std::string rootDir;
+    size_t capacity;
+    size_t maxEntryBytes;
+    int precompressLevel;
+    Shard shards[SHARD_COUNT];
+    std::atomic<uint64_t> hitCount;
+    std::atomic<uint64_t> missCount;
+    std::atomic<uint64_t> evictionCount;
+    std::atomic<uint64_t> invalidationCount;
+
+    // Watcher thread state; watchDirs is only touched by startWatcher() and the watcher
+    int inotifyFd;
+    int wakeFd;
+    std::atomic<bool> watching;
+    std::thread watcher;
+    std::unordered_map<int, std::string> watchDirs;
+
+    static std::string normalize(std::string_view path) {
+        std::string normal;
+        normalizeInto(path, normal);
+        return normal;
+    }
+
+    // Same result as lexically_normal(), which allocates per component; paths that are
+    // already normal apart from leading "./" (every request under --root .) are copied as is
+    static void normalizeInto(std::string_view path, std::string& out) {
+        std::string_view rest = path;
+        while (rest.substr(0, 2) == "./") rest.remove_prefix(2);
+        if (isPlainPath(rest)) {
+            out.assign(rest);
+            return;
+        }
+        out = std::filesystem::path(path).lexically_normal().string();
+    }
+
+    // No empty, "." or ".." segments
+    static bool isPlainPath(std::string_view path) {
+        if (path.empty() || path.find("//") != std::string_view::npos) return false;
+        size_t start = 0;
+        while (start < path.size()) {
+            size_t end = std::min(path.find('/', start), path.size());
+            std::string_view segment = path.substr(start, end - start);
+            if (segment == "." || segment == "..") return false;
+            start = end + 1;
+        }
+        return true;
+    }
+
+    Shard& shardFor(const std::string& key) {
+        return shards[std::hash<std::string>()(key) % SHARD_COUNT];
+    }
+
+    std::shared_ptr<const CachedAsset> load(const std::string& fullPath) const {
+        int fd = open(fullPath.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return nullptr;
+        struct stat st;
+        if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+            close(fd);
+            return nullptr;
+        }
+
+        auto asset = std::make_shared<CachedAsset>();
+        asset->fullPath = fullPath;
+        asset->contentType = contentTypeFor(std::filesystem::path(fullPath).extension().string());
+        asset->size = st.st_size;
+        asset->mtime = st.st_mtim;
+        bool compressible = Compression::compressibleType(asset->contentType);
+        asset->identity.headers = entityHeaders(*asset, asset->size, ContentCoding::Identity);
+        std::string etag = ConditionalRequest::fileETag(st);
+        // HTML is compressed per response, which adds its own Vary
+        if (asset->isHtml()) setValidators(*asset, asset->identity, "W/" + etag, false);
+        else setValidators(*asset, asset->identity, etag, compressible);
+
+        if (capacity > 0 && asset->size <= maxEntryBytes) {
+            auto bytes = std::make_shared<std::string>(asset->size, '\0');
+            size_t done = 0;
+            while (done < bytes->size()) {
+                ssize_t n = read(fd, &(*bytes)[done], bytes->size() - done);
+                if (n < 0 && errno == EINTR) continue;
+                if (n <= 0) break;
+                done += n;
+            }
+            if (done == bytes->size()) asset->identity.bytes = std::move(bytes);
+        }
+        close(fd);
+
+        // Fingerprinted HTML is rewritten per response, so only other text is precompressed
+        if (asset->identity.bytes && compressible && !asset->isHtml() && precompressLevel > 0) {
+            precompress(*asset, ContentCoding::Gzip, st, asset->gzip);
+            precompress(*asset, ContentCoding::Deflate, st, asset->deflate);
+        }
+        return asset;
+    }
+
+    static std::string entityHeaders(const CachedAsset& asset, size_t length, ContentCoding coding) {
+        std::string headers = "Content-Type: " + asset.contentType + "; charset=utf-8\r\n"
+                              "Content-Length: " + std::to_string(length) + "\r\n";
+        // Range requests are answered from the identity body; fingerprinted HTML never is
+        if (!asset.isHtml()) headers += "Accept-Ranges: bytes\r\n";
+        if (coding != ContentCoding::Identity) {
+            headers += "Content-Encoding: " + std::string(Compression::codingName(coding)) + "\r\n";
+        }
+        return headers;
+    }
+
+    static void setValidators(const CachedAsset& asset, AssetBody& body, const std::string& etag, bool vary) {
+        body.etag = etag;
+        body.validators = "ETag: " + etag + "\r\n"
+                          "Last-Modified: " + ConditionalRequest::httpDate(asset.mtime.tv_sec) + "\r\n";
+        if (vary) body.validators += "Vary: Accept-Encoding\r\n";
+    }
+
+    // Keep the variant only if it saves at least a tenth of the raw size
+    void precompress(const CachedAsset& asset, ContentCoding coding, const struct stat& st, AssetBody& body) const {
+        const std::string& raw = *asset.identity.bytes;
+        auto compressed = std::make_shared<std::string>();
+        if (!Compression::compress(raw, coding, precompressLevel, *compressed)) return;
+        if (compressed->size() > raw.size() - raw.size() / 10) return;
+        compressed->shrink_to_fit();
+        body.headers = entityHeaders(asset, compressed->size(), coding);
+        setValidators(asset, body, ConditionalRequest::fileETag(st, Compression::codingName(coding)), true);
+        body.bytes = std::move(compressed);
+    }
+
+    void insert(Shard& shard, const std::string& key, const std::shared_ptr<const CachedAsset>& asset,
+                uint64_t generation) {
+        size_t cost = ENTRY_OVERHEAD + key.size();
+        for (const AssetBody* body : {&asset->identity, &asset->gzip, &asset->deflate}) {
+            if (body->bytes) cost += body->bytes->size();
+        }
+        size_t shardCapacity = capacity / SHARD_COUNT;
+        if (cost > shardCapacity) return;
+
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        if (shard.generation != generation) return;
+        auto existing = shard.entries.find(key);
+        if (existing != shard.entries.end()) removeEntry(shard, existing);
+
+        while (shard.bytes + cost > shardCapacity && !shard.lru.empty()) {
+            removeEntry(shard, shard.entries.find(shard.lru.back()));
+            evictionCount.fetch_add(1, std::memory_order_relaxed);
+        }
+        shard.lru.push_front(key);
+        shard.entries[key] = Entry{asset, shard.lru.begin(), cost};
+        shard.bytes += cost;
+    }
+
+    void removeEntry(Shard& shard, std::unordered_map<std::string, Entry>::iterator it) {
+        shard.bytes -= it->second.cost;
+        shard.lru.erase(it->second.position);
+        shard.entries.erase(it);
+    }
+
+    static constexpr uint32_t WATCH_MASK = IN_CLOSE_WRITE | IN_MODIFY | IN_ATTRIB | IN_CREATE | IN_DELETE |
+                                           IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF | IN_MOVE_SELF;
+
+    void watchDirectory(const std::string& dir) {
+        int wd = inotify_add_watch(inotifyFd, dir.c_str(), WATCH_MASK | IN_ONLYDIR);
+        if (wd >= 0) watchDirs[wd] = dir;
+    }
+
+    void watchTree(const std::string& dir) {
+        watchDirectory(normalize(dir));
+        std::error_code error;
+        std::filesystem::recursive_directory_iterator it(dir, std::filesystem::directory_options::skip_permission_denied, error);
+        for (; !error && it != std::filesystem::recursive_directory_iterator(); it.increment(error)) {
+            if (it->is_directory(error) && !it->is_symlink(error)) watchDirectory(normalize(it->path().string()));
+        }
+    }
+
+    void watchLoop() {
+        alignas(inotify_event) char buffer[64 * 1024];
+        pollfd fds[2] = {{inotifyFd, POLLIN, 0}, {wakeFd, POLLIN, 0}};
+        while (watching) {
+            if (poll(fds, 2, -1) < 0) {
+                if (errno == EINTR) continue;
+                break;
+            }
+            if (fds[1].revents) break;
+
+            ssize_t n;
+            while ((n = read(inotifyFd, buffer, sizeof(buffer))) > 0) {
+                for (char* p = buffer; p < buffer + n;) {
+                    const inotify_event* event = reinterpret_cast<const inotify_event*>(p);
+                    handleEvent(*event);
+                    p += sizeof(inotify_event) + event->len;
+                }
+            }
+        }
+    }
+
+    void handleEvent(const inotify_event& event) {
+        if (event.mask & IN_Q_OVERFLOW) {
+            clear(); // events were lost, nothing cached can be trusted
+            return;
+        }
+        auto dir = watchDirs.find(event.wd);
+        if (dir == watchDirs.end()) return;
+        if (event.mask & IN_IGNORED) {
+            watchDirs.erase(dir);
+            return;
+        }
+        if (event.len == 0) return; // event on the directory itself, its entries report separately
+
+        std::string path = normalize((std::filesystem::path(dir->second) / event.name).string());
+        if (event.mask & IN_ISDIR) {
+            // A directory appearing or moving changes every path below it
+            if (event.mask & (IN_CREATE | IN_MOVED_TO)) watchTree(path);
+            if (event.mask & (IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE)) clear();
+            return;
+        }
+        invalidate(path);
+    }
+
+    void closeWatcherFds() {
+        if (inotifyFd >= 0) close(inotifyFd);
+        if (wakeFd >= 0) close(wakeFd);
+        inotifyFd = -1;
+        wakeFd = -1;
+        watchDirs.clear();
+    }
+};
+
+#endif // STATIC_CACHE_H
@@ -0,0 +1,15 @@
+#ifndef TALLY_ASM_H
+#define TALLY_ASM_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Routines from tally-asm.S (link tally-asm.o)
+extern "C" {
+// XOR/rotate hash of `length` bytes
+uint64_t tally_hash_data(const void* data, size_t length);
+// Zero `length` bytes, then fence so the stores are visible before returning
+void tally_secure_zero(void* data, size_t length);
+}
+
+#endif // TALLY_ASM_H
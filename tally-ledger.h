@@ -0,0 +1,129 @@
+#ifndef TALLY_LEDGER_H
+#define TALLY_LEDGER_H
+
+#include <atomic>
+#include <cstdint>
+#include <ctime>
+#include <openssl/evp.h>
+#include <openssl/sha.h>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "trace.h"
+
+// Tally System Core Classes
+// Balances and the hashed transaction log behind /api/tally/*
+class TallyLedger {
+private:
+    struct TallyTransaction {
+        std::string hash;
+        std::string from;
+        std::string to;
+        int amount;
+        time_t timestamp;
+        std::string narrative; // The King's Reckoning story segments
+    };
+
+    std::vector<TallyTransaction> ledger;
+    std::unordered_map<std::string, int> balances;
+    std::atomic<uint64_t> version{0}; // bumped by every transfer, drives API ETags
+
+public:
+    TallyLedger() {
+        // Initialize with genesis tallies
+        balances["user"] = 1;
+        balances["network"] = 1;
+
+        // Add genesis transaction
+        TallyTransaction genesis{
+            "genesis_hash", "system", "user", 1, time(nullptr), "The King's first tally - sovereignty granted"
+        };
+        ledger.push_back(genesis);
+
+        TallyTransaction networkGenesis{
+            "network_genesis", "system", "network", 1, time(nullptr), "Network tally created - collective power"
+        };
+        ledger.push_back(networkGenesis);
+    }
+
+    bool transfer(const std::string& from, const std::string& to, int amount, const std::string& narrative = "") {
+        TraceSpan span("ledger.transfer");
+        if (balances[from] < amount) return false;
+
+        std::string hash = generateHash(from + to + std::to_string(amount) + narrative + std::to_string(time(nullptr)));
+
+        TallyTransaction tx{hash, from, to, amount, time(nullptr), narrative};
+        ledger.push_back(tx);
+
+        balances[from] -= amount;
+        balances[to] += amount;
+        version.fetch_add(1, std::memory_order_release);
+
+        return true;
+    }
+
+    uint64_t getVersion() const {
+        return version.load(std::memory_order_acquire);
+    }
+
+    int getBalance(const std::string& account) {
+        return balances[account];
+    }
+
+    bool combineTallies() {
+        if (balances["user"] == 1 && balances["network"] == 1) {
+            // Create combined sovereignty state
+            transfer("user", "collective", 1, "Individual sovereignty surrendered for collective power");
+            transfer("network", "collective", 1, "Network power merged into collective decision-making");
+            return true;
+        }
+        return false;
+    }
+
+    bool separateTallies() {
+        if (balances["collective"] == 2) {
+            transfer("collective", "user", 1, "Individual sovereignty restored");
+            transfer("collective", "network", 1, "Network autonomy reestablished");
+            return true;
+        }
+        return false;
+    }
+
+    std::string generateHash(const std::string& data) {
+        TraceSpan span("ledger.hash");
+        unsigned char hash[SHA256_DIGEST_LENGTH];
+        EVP_MD_CTX* context = EVP_MD_CTX_new();
+
+        if (!context) return "hash_error";
+
+        if (EVP_DigestInit_ex(context, EVP_sha256(), NULL) &&
+            EVP_DigestUpdate(context, data.c_str(), data.size()) &&
+            EVP_DigestFinal_ex(context, hash, NULL)) {
+
+            static const char digits[] = "0123456789abcdef";
+            std::string hex(SHA256_DIGEST_LENGTH * 2, '0');
+            for (int i = 0; i < SHA256_DIGEST_LENGTH; i++) {
+                hex[i * 2] = digits[hash[i] >> 4];
+                hex[i * 2 + 1] = digits[hash[i] & 0x0f];
+            }
+            EVP_MD_CTX_free(context);
+            return hex;
+        }
+
+        EVP_MD_CTX_free(context);
+        return "hash_error";
+    }
+
+    std::string getLedgerSummary() const {
+        std::stringstream ss;
+        ss << "Tally Ledger Summary:\n";
+        ss << "User Balance: " << (balances.count("user") ? balances.at("user") : 0) << "\n";
+        ss << "Network Balance: " << (balances.count("network") ? balances.at("network") : 0) << "\n";
+        ss << "Collective Balance: " << (balances.count("collective") ? balances.at("collective") : 0) << "\n";
+        ss << "Total Transactions: " << ledger.size() << "\n";
+        return ss.str();
+    }
+};
+
+#endif // TALLY_LEDGER_H
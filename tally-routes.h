@@ -0,0 +1,57 @@
+#ifndef TALLY_ROUTES_H
+#define TALLY_ROUTES_H
+
+#include <iterator>
+#include "route-table.h"
+
+// API endpoints served by TallyServer; anything else falls through to static files
+enum class TallyRoute {
+    TallyCombine,
+    TallySeparate,
+    TallyStatus,
+    ServerStats,
+    ServerInfo,
+    NetworkPeers,
+    NetworkAddPeer,
+    NetworkInfo,
+    NetworkPublicKey,
+    NetworkDiscover,
+    NetworkChallenge,
+    NetworkSend,
+    NetworkScan,
+    NetworkOptimize,
+    NetworkStatus,
+    Metrics,
+    ServerTrace,
+};
+
+// State-changing endpoints also take GET so existing curl scripts keep working
+inline constexpr uint8_t ROUTE_READ = ROUTE_GET;
+inline constexpr uint8_t ROUTE_ACTION = ROUTE_GET | ROUTE_POST;
+
+inline constexpr RouteSpec TALLY_ROUTE_SPECS[] = {
+    {ROUTE_ACTION, "/api/tally/combine", (int)TallyRoute::TallyCombine},
+    {ROUTE_ACTION, "/api/tally/separate", (int)TallyRoute::TallySeparate},
+    {ROUTE_READ, "/api/tally/status", (int)TallyRoute::TallyStatus},
+    {ROUTE_READ, "/api/server/stats", (int)TallyRoute::ServerStats},
+    {ROUTE_READ, "/api/server/info", (int)TallyRoute::ServerInfo},
+    {ROUTE_READ, "/api/network/peers", (int)TallyRoute::NetworkPeers},
+    {ROUTE_ACTION, "/api/network/add-peer", (int)TallyRoute::NetworkAddPeer},
+    {ROUTE_READ, "/api/network/info", (int)TallyRoute::NetworkInfo},
+    {ROUTE_READ, "/api/network/public-key", (int)TallyRoute::NetworkPublicKey},
+    {ROUTE_ACTION, "/api/network/discover", (int)TallyRoute::NetworkDiscover},
+    {ROUTE_ACTION, "/api/network/challenge", (int)TallyRoute::NetworkChallenge},
+    {ROUTE_ACTION, "/api/network/send/{peer}", (int)TallyRoute::NetworkSend},
+    {ROUTE_ACTION, "/api/network/scan", (int)TallyRoute::NetworkScan},
+    {ROUTE_ACTION, "/api/network/optimize", (int)TallyRoute::NetworkOptimize},
+    {ROUTE_READ, "/api/network/status", (int)TallyRoute::NetworkStatus},
+    {ROUTE_READ, "/metrics", (int)TallyRoute::Metrics},
+    {ROUTE_GET | ROUTE_POST, "/api/server/trace", (int)TallyRoute::ServerTrace},
+};
+
+inline constexpr RouteTable<std::size(TALLY_ROUTE_SPECS)> TALLY_ROUTES(TALLY_ROUTE_SPECS);
+static_assert(TALLY_ROUTES.valid(), "no perfect hash seed for the tally routes");
+static_assert(TALLY_ROUTES.match("GET", "/api/network/send/peer_1").id == (int)TallyRoute::NetworkSend,
+              "parameter routes must match by prefix");
+
+#endif // TALLY_ROUTES_H
@@ -42,6 +42,31 @@
 #include <mutex>
 #include <condition_variable>
 #include <cstring>
+#include <memory>
+#include "event-loop.h"
+#include "thread-pool.h"
+#include "http-parser.h"
+#include "listener.h"
+#include "send-queue.h"
+#include "response-writer.h"
+#include "compression.h"
+#include "conditional.h"
+#include "byte-range.h"
+#include "static-cache.h"
+#include "tally-routes.h"
+#include "alloc-stats.h"
+#include "request-arena.h"
+#include "async-logger.h"
+#include "metrics.h"
+#include "trace.h"
+#include "tls-session.h"
+#include "peer-network.h"
+#include "tally-ledger.h"
+#include "page-fingerprint.h"
+#include "admission-control.h"
+#include "timer-wheel.h"
+#include "io-backend.h"
+#include "io-uring.h"
 
 // Socket includes for cross-platform compatibility
 #ifdef _WIN32
@@ -64,600 +89,1025 @@
 
 namespace fs = std::filesystem;
 
-// Tailscale Replacement - Network Tunneling Classes
-class NetworkTunnel {
-private:
-    int tun_fd;
-    std::string tunnel_ip;
-    std::unordered_set<std::string> peer_ips;
-    std::mutex peer_mutex;
-    std::atomic<bool> running;
-    std::thread tunnel_thread;
+// Startup tuning for the connection handling model
+struct TallyServerOptions {
+    std::string ioModel = "threads"; // "threads" (worker pool), "epoll" or "uring"
+    int eventLoops = 0;              // epoll / io_uring loop threads, 0 = one per core
+    int workerThreads = 0;           // worker pool size for the threads model, 0 = one per core
+    int keepAliveTimeout = 5;        // idle seconds before a persistent connection closes, 0 disables keep-alive
+    int keepAliveRequests = 100;     // requests served on one connection before it closes
+    int listeners = 1;               // SO_REUSEPORT listening sockets, each drained by its own acceptor
+    int backlog = SOMAXCONN;         // listen() backlog for every listening socket
+    bool pinCpus = false;            // pin accept threads / event loops to one core each
+    size_t staticCacheMB = 64;       // static asset cache memory cap, 0 disables caching
+    bool warmCache = false;          // load the root directory into the cache at startup
+    int compressionLevel = 6;        // zlib level for dynamic bodies, 0 disables compression entirely
+    size_t compressMinBytes = 1024;  // smallest dynamic body worth compressing
+    std::string fingerprintMode = "window"; // HTML fingerprint: "request", "version" or "window"
+    int fingerprintWindow = 60;      // seconds one fingerprint lasts in "window" mode
+    LogLevel logLevel = LogLevel::Info;
+    std::string accessLogFile;       // empty: no access log
+    bool trace = false;              // record hot-path spans from startup (see /api/server/trace)
+    int maxConnections = 4096;       // admitted connections before new ones get 503, 0 = unlimited
+    size_t maxQueued = 1024;         // connections waiting for a worker (threads model), 0 = unlimited
+    int shedPercent = 80;            // past this % of either limit only /api/tally/* requests are served
+    int retryAfter = 1;              // Retry-After seconds on 503s
+    int headerTimeout = 10;          // seconds to receive a whole request head
+    int bodyTimeout = 30;            // seconds allowed between two reads of a request body
+    int writeTimeout = 30;           // seconds allowed between two writes of a response
+    int tlsPort = 0;                 // HTTPS listening port, 0 disables TLS
+    TlsContext::Options tls;         // certificate, key, session cache and kTLS settings
+};
 
-    bool createTunDevice() {
-        struct ifreq ifr;
-        int err;
+// One response written straight onto its connection's send queue, and whether the
+// connection stays open afterwards. The head is formatted into the queue's recycled tail
+// buffer; bodies are moved, shared or sent from the file so they are never copied.
+// Scratch strings for the request come from the connection's arena.
+struct HttpResponse {
+    HttpResponse(SendQueue& output, RequestArena& arena) : output(output), arena(arena) {}
+
+    SendQueue& output;
+    RequestArena& arena;
+    bool keepAlive = false;
+    ContentCoding acceptEncoding = ContentCoding::Identity; // best coding the client accepts
+    int status = 0;                                         // filled in by head().status()
+    int route = -1;                                         // TallyRoute, -1 for static files
+
+    ResponseWriter head() { return ResponseWriter(output, &status); }
+};
 
-        if ((tun_fd = open("/dev/net/tun", O_RDWR)) < 0) {
-            return false;
-        }
+class TallyServer {
+private:
+    int port;
+    std::atomic<bool> running;
+    std::string rootDir;
+    TallyLedger tallyLedger;
+    std::string pidFile;
+    std::string logFile;
+    TallyServerOptions options;
+
+    // Largest request head (and body) accepted before answering 431/413 and closing
+    static constexpr size_t MAX_REQUEST_SIZE = 64 * 1024;
+    static constexpr size_t INLINE_BODY_BYTES = 4096; // dynamic bodies up to this are copied beside the head
+
+    class LoopConnection;
+    class ConnectionWaiter;
+
+    // What a connection is waiting on, each with its own deadline
+    enum class ConnectionPhase { Header, Body, Write, Idle };
+    static constexpr const char* PHASE_NAMES[] = {"header", "body", "write", "idle"};
+    std::atomic<uint64_t> connectionTimeouts[4] = {};
+
+    // One epoll reactor thread and the connections it owns
+    struct LoopContext {
+        std::unique_ptr<EventLoop> loop;
+        std::unique_ptr<EventLoop::Handler> acceptor;
+        TimerWheel deadlines; // declared before connections, which disarm their timers on destruction
+        std::unordered_map<int, std::unique_ptr<LoopConnection>> connections;
+        std::thread thread;
+        int listenSocket = -1;
+        std::unique_ptr<EventLoop::Handler> tlsAcceptor;
+        int tlsListenSocket = -1; // -1 without TLS
+        AcceptStats* acceptStats = nullptr;
+    };
 
-        memset(&ifr, 0, sizeof(ifr));
-        ifr.ifr_flags = IFF_TUN | IFF_NO_PI;
+    // One entry per accept thread (threads model) or event loop (epoll model)
+    struct Acceptor {
+        int listener = 0; // index into listenSockets
+        bool tls = false; // listener is on the TLS port
+        AcceptStats stats;
+    };
+    std::vector<std::unique_ptr<Acceptor>> acceptors;
+    std::vector<int> listenSockets;  // plaintext listeners, then as many TLS ones
+    size_t plainListeners = 0;
+
+    // HTTPS on options.tlsPort, created by start() when TLS is enabled
+    std::unique_ptr<TlsContext> tlsContext;
+
+    // Runs serveConnection work items for the threads model
+    std::unique_ptr<WorkStealingPool> workerPool;
+
+    // Holds threads-model connections while they wait for input, off the worker pool
+    std::unique_ptr<ConnectionWaiter> connectionWaiter;
+
+    // Connection handling for the chosen --io-model, created by start()
+    std::unique_ptr<IoBackend> backend;
+
+    // Static files by path, invalidated by inotify
+    std::unique_ptr<StaticAssetCache> assetCache;
+
+    // Connection/Keep-Alive lines for persistent responses, formatted once from the options
+    std::string keepAliveHeaders;
+
+    // Server log and optional per-request access log, both written off the request path
+    AsyncLogger logger;
+    AsyncLogger accessLog{16384};
+
+    // Per-route counters and latency histograms for /metrics; the last route is "static"
+    std::unique_ptr<RequestMetrics> requestMetrics;
+
+    // Fingerprinted HTML for one file version (and time window). The comment is
+    // spliced in at send time, so the page itself is never copied per response.
+    struct FingerprintedPage {
+        std::string etag;                        // file version the page was built from
+        long long window = 0;                    // time window it is valid for ("window" mode)
+        std::string versionHash;                 // SHA-256 over content and path
+        std::string validator;                   // ETag of this page, which names the window too
+        std::string validators;                  // ETag (and Last-Modified in "version" mode)
+        std::shared_ptr<const std::string> content;
+        size_t splice = std::string::npos;       // just past the <body ...> tag, npos if none
+        std::string comment;
+        std::shared_ptr<const std::string> gzip; // whole fingerprinted page, compressed once
+        std::shared_ptr<const std::string> deflate;
+    };
+    std::mutex fingerprintMutex;
+    std::unordered_map<std::string, std::shared_ptr<const FingerprintedPage>> fingerprintPages;
+
+    // Accepts every pending connection on one of the loop's listening sockets
+    class LoopAcceptor : public EventLoop::Handler {
+    public:
+        LoopAcceptor(TallyServer* server, LoopContext* context, int listenSocket, bool tls)
+            : server(server), context(context), listenSocket(listenSocket), tls(tls) {}
+
+        void onEvents(uint32_t) override {
+            while (true) {
+                sockaddr_in clientAddr;
+                socklen_t clientAddrLen = sizeof(clientAddr);
+                int clientSocket = accept4(listenSocket, (sockaddr*)&clientAddr, &clientAddrLen,
+                                           SOCK_NONBLOCK | SOCK_CLOEXEC);
+                if (clientSocket < 0) {
+                    if (errno == EINTR) continue;
+                    if (errno != EAGAIN && errno != EWOULDBLOCK && server->running) {
+                        std::cerr << "Accept failed: " << SOCKET_ERROR_CODE << std::endl;
+                    }
+                    return;
+                }
 
-        if (ioctl(tun_fd, TUNSETIFF, (void *)&ifr) < 0) {
-            close(tun_fd);
-            return false;
+                context->acceptStats->record();
+                if (!server->admission.tryAdmitConnection(0)) {
+                    server->admission.rejectConnection(clientSocket);
+                    CLOSE_SOCKET(clientSocket);
+                    continue;
+                }
+                std::string clientIP = inet_ntoa(clientAddr.sin_addr);
+                server->trackSession(clientIP);
+
+                auto connection = std::make_unique<LoopConnection>(server, context, clientSocket, clientIP,
+                                                                   tls ? server->tlsContext.get() : nullptr);
+                if (!context->loop->add(clientSocket, EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET, connection.get())) {
+                    CLOSE_SOCKET(clientSocket);
+                    server->admission.releaseConnection();
+                    continue;
+                }
+                connection->updateDeadline();
+                context->connections[clientSocket] = std::move(connection);
+            }
         }
 
-        return true;
-    }
-
-    void setupTunnelIp() {
-        // Set tunnel IP address (10.0.0.x)
-        std::string cmd = "ip addr add " + tunnel_ip + "/24 dev " + getTunName() + "\n";
-        cmd += "ip link set " + getTunName() + " up\n";
-        system(cmd.c_str());
-    }
-
-    std::string getTunName() {
-        return "tun0"; // Fixed name for simplicity
-    }
+    private:
+        TallyServer* server;
+        LoopContext* context;
+        int listenSocket;
+        bool tls;
+    };
 
-    void tunnelWorker() {
-        char buffer[1500];
-        while (running) {
-            ssize_t nread = read(tun_fd, buffer, sizeof(buffer));
-            if (nread > 0) {
-                handleTunnelPacket(buffer, nread);
+    // Parse and serve state of one non-blocking persistent connection, shared by the epoll
+    // and io_uring backends. Pipelined requests are answered strictly in arrival order
+    // through a single output queue. A timer on the owning loop's wheel closes the
+    // connection when the client stalls.
+    class LoopSession : protected TimerWheel::Timer {
+    public:
+        LoopSession(TallyServer* server, TimerWheel& deadlines, int fd, const std::string& clientIP)
+            : server(server), deadlines(deadlines), fd(fd), clientIP(clientIP) {}
+
+        // Arm the deadline for whatever the connection now waits on. A head deadline runs
+        // from the request's first byte (or the accept) and is never extended; body and
+        // write deadlines restart on every event, i.e. whenever the client makes progress.
+        void updateDeadline() {
+            ConnectionPhase next;
+            if (!output.empty()) next = ConnectionPhase::Write;
+            else if (parser.readingBody()) next = ConnectionPhase::Body;
+            else if (!input.empty() || served == 0 || !server->keepAliveEnabled()) next = ConnectionPhase::Header;
+            else next = ConnectionPhase::Idle;
+
+            bool progressTimed = next == ConnectionPhase::Body || next == ConnectionPhase::Write;
+            if (next == phase && armed() && !progressTimed && deadlineRequest == served) return;
+            phase = next;
+            deadlineRequest = served;
+            deadlines.schedule(*this, server->phaseTimeout(phase));
+        }
+
+        // Close the socket; may destroy this, so callers return straight afterwards
+        virtual void closeConnection() = 0;
+
+    protected:
+        // Stop reading pipelined requests while this much response data is unsent
+        static constexpr size_t MAX_PENDING_OUTPUT = 1024 * 1024;
+
+        TallyServer* server;
+        TimerWheel& deadlines;
+        int fd;
+        std::string clientIP;
+        std::string input;
+        HttpParser parser{MAX_REQUEST_SIZE, MAX_REQUEST_SIZE};
+        SendQueue output;
+        RequestArena arena;
+        int served = 0;
+        bool closeAfterFlush = false;
+        bool peerClosed = false;
+        ConnectionPhase phase = ConnectionPhase::Header;
+        int deadlineRequest = 0; // `served` when the deadline was armed
+
+        void onTimeout() override {
+            server->countTimeout(phase);
+            closeConnection();
+        }
+
+        // Answer every complete request in `input`, queueing the responses on `output`
+        void processRequests() {
+            while (!closeAfterFlush) {
+                TraceSpan parseSpan("parse");
+                HttpParser::Status status = parser.parse(input);
+                parseSpan.end();
+                if (status == HttpParser::Status::Incomplete) return;
+
+                HttpResponse response(output, arena);
+                if (status == HttpParser::Status::Error) {
+                    server->rejectRequest(response, parser.errorCode());
+                } else {
+                    response.keepAlive = ++served < server->options.keepAliveRequests && server->keepAliveEnabled();
+                    server->serveRequest(parser.request(), response, clientIP);
+                    input.erase(0, parser.consumed());
+                    parser.reset();
+                }
+                arena.reset();
+                if (!response.keepAlive) closeAfterFlush = true;
             }
-            std::this_thread::sleep_for(std::chrono::milliseconds(10));
         }
-    }
-
-    void handleTunnelPacket(const char* packet, size_t length) {
-        // Basic packet routing logic
-        // For demo purposes, just log the packet
-        std::cout << "📦 Tunnel packet: " << length << " bytes" << std::endl;
-    }
-
-public:
-    NetworkTunnel(const std::string& ip = "10.0.0.1") : tunnel_ip(ip), running(false), tun_fd(-1) {}
-
-    ~NetworkTunnel() {
-        stop();
-    }
+    };
 
-    bool start() {
-        if (!createTunDevice()) {
-            std::cerr << "❌ Failed to create tunnel device" << std::endl;
-            return false;
+    // Edge-triggered epoll connection driven entirely by its owning loop. TLS connections
+    // complete the handshake first, under the deadline armed at accept for the first head.
+    class LoopConnection : public EventLoop::Handler, public LoopSession {
+    public:
+        LoopConnection(TallyServer* server, LoopContext* context, int fd, const std::string& clientIP,
+                       TlsContext* tlsContext = nullptr)
+            : LoopSession(server, context->deadlines, fd, clientIP), context(context), readPaused(false) {
+            if (tlsContext) tls = std::make_unique<TlsSession>(*tlsContext, fd);
         }
 
-        setupTunnelIp();
-        running = true;
-        tunnel_thread = std::thread(&NetworkTunnel::tunnelWorker, this);
+        void onEvents(uint32_t events) override {
+            if (events & EPOLLERR) {
+                closeConnection();
+                return;
+            }
 
-        std::cout << "✅ Network tunnel started: " << tunnel_ip << std::endl;
-        return true;
-    }
+            if (tls && !tls->isEstablished()) {
+                TlsSession::Status status = tls->handshake();
+                if (status == TlsSession::Status::Error) {
+                    closeConnection();
+                    return;
+                }
+                if (status != TlsSession::Status::Done) return;
+                events |= EPOLLIN; // the first request may have arrived with the client's Finished
+            }
 
-    void stop() {
-        running = false;
-        if (tunnel_thread.joinable()) {
-            tunnel_thread.join();
-        }
-        if (tun_fd >= 0) {
-            close(tun_fd);
+            if ((events & EPOLLIN) && !readPaused) {
+                if (!readAvailable()) return;
+            }
+            if (!flush()) return;
+            updateDeadline();
+        }
+
+        void closeConnection() override {
+            if (tls) tls->shutdown();
+            context->loop->remove(fd);
+            CLOSE_SOCKET(fd);
+            server->admission.releaseConnection();
+            context->connections.erase(fd); // destroys this
+        }
+
+    private:
+        LoopContext* context;
+        bool readPaused;
+        std::unique_ptr<TlsSession> tls;
+
+        // Drain the socket, answering each complete request as it arrives; false if closed
+        bool readAvailable() {
+            char buffer[8192];
+            while (!closeAfterFlush) {
+                if (output.pendingBytes() > MAX_PENDING_OUTPUT) {
+                    readPaused = true; // resumed by flush() once the client catches up
+                    return true;
+                }
+                TraceSpan recvSpan("recv");
+                ssize_t n = tls ? tls->read(buffer, sizeof(buffer)) : recv(fd, buffer, sizeof(buffer), 0);
+                recvSpan.end();
+                if (n > 0) {
+                    input.append(buffer, n);
+                    processRequests();
+                    continue;
+                }
+                if (n < 0 && errno == EINTR) continue;
+                if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return true;
+                if (n == 0) {
+                    peerClosed = true; // answer what already arrived, then close
+                    return true;
+                }
+                closeConnection();
+                return false;
+            }
+            return true;
         }
-    }
 
-    void addPeer(const std::string& peer_ip) {
-        std::lock_guard<std::mutex> lock(peer_mutex);
-        peer_ips.insert(peer_ip);
-        std::cout << "➕ Peer added: " << peer_ip << std::endl;
-    }
-
-    void removePeer(const std::string& peer_ip) {
-        std::lock_guard<std::mutex> lock(peer_mutex);
-        peer_ips.erase(peer_ip);
-        std::cout << "➖ Peer removed: " << peer_ip << std::endl;
-    }
-
-    std::vector<std::string> getPeers() {
-        std::lock_guard<std::mutex> lock(peer_mutex);
-        return std::vector<std::string>(peer_ips.begin(), peer_ips.end());
-    }
-};
-
-class SecurePeer {
-private:
-    std::string peer_id;
-    std::string public_key;
-    std::string ip_address;
-    time_t last_seen;
-    bool authenticated;
-
-public:
-    SecurePeer(const std::string& id, const std::string& ip, const std::string& pubkey = "")
-        : peer_id(id), ip_address(ip), public_key(pubkey), last_seen(time(nullptr)), authenticated(false) {}
-
-    void updateLastSeen() { last_seen = time(nullptr); }
-    bool isAuthenticated() const { return authenticated; }
-    void setAuthenticated(bool auth) { authenticated = auth; }
-    std::string getId() const { return peer_id; }
-    std::string getIp() const { return ip_address; }
-    std::string getPublicKey() const { return public_key; }
-    time_t getLastSeen() const { return last_seen; }
-
-    bool isExpired(int timeout_sec = 300) const {
-        return (time(nullptr) - last_seen) > timeout_sec;
-    }
-};
-
-class PeerNetwork {
-private:
-    std::unordered_map<std::string, SecurePeer> peers;
-    mutable std::mutex peers_mutex;
-    NetworkTunnel tunnel;
-    std::string node_id;
-    std::string node_ip;
-    std::string private_key;
-    std::string public_key;
-    std::unordered_map<std::string, std::string> session_keys;
-
-    std::string generateNodeId() {
-        unsigned char random_bytes[16];
-        RAND_bytes(random_bytes, sizeof(random_bytes));
+        // Write buffered responses; false if the connection was closed
+        bool flush() {
+            TraceSpan sendSpan("send");
+            SendQueue::Result result = tls ? tls->write(output) : output.writeTo(fd);
+            sendSpan.end();
+            if (result == SendQueue::Result::WouldBlock) return true; // wait for EPOLLOUT
+            if (result == SendQueue::Result::Error) {
+                closeConnection();
+                return false;
+            }
 
-        std::stringstream ss;
-        for (int i = 0; i < 16; i++) {
-            ss << std::hex << std::setw(2) << std::setfill('0') << (int)random_bytes[i];
+            if (closeAfterFlush || peerClosed) {
+                closeConnection();
+                return false;
+            }
+            if (readPaused) {
+                readPaused = false;
+                return readAvailable() && flush();
+            }
+            return true;
         }
-        return ss.str();
-    }
-
-    void generateKeyPair() {
-        // Generate RSA key pair for node authentication
-        EVP_PKEY_CTX* ctx = EVP_PKEY_CTX_new_id(EVP_PKEY_RSA, NULL);
-        if (!ctx) return;
-
-        if (EVP_PKEY_keygen_init(ctx) > 0 &&
-            EVP_PKEY_CTX_set_rsa_keygen_bits(ctx, 2048) > 0) {
-            EVP_PKEY* pkey = NULL;
-            if (EVP_PKEY_keygen(ctx, &pkey) > 0) {
-                // Store private key
-                BIO* bio_private = BIO_new(BIO_s_mem());
-                PEM_write_bio_PrivateKey(bio_private, pkey, NULL, NULL, 0, NULL, NULL);
-                char* private_data;
-                long private_len = BIO_get_mem_data(bio_private, &private_data);
-                private_key = std::string(private_data, private_len);
-                BIO_free(bio_private);
-
-                // Store public key
-                BIO* bio_public = BIO_new(BIO_s_mem());
-                PEM_write_bio_PUBKEY(bio_public, pkey);
-                char* public_data;
-                long public_len = BIO_get_mem_data(bio_public, &public_data);
-                public_key = std::string(public_data, public_len);
-                BIO_free(bio_public);
-            }
-            EVP_PKEY_free(pkey);
-        }
-        EVP_PKEY_CTX_free(ctx);
-    }
+    };
 
-    std::string encryptMessage(const std::string& message, const std::string& peer_id) {
-        // AES encryption for secure messaging
-        EVP_CIPHER_CTX* ctx = EVP_CIPHER_CTX_new();
-        if (!ctx) return "";
+    // Epoll reactors: a fixed set of loop threads drain the listening sockets and own
+    // accept, read, parse and write for every connection they accept
+    class EpollBackend : public IoBackend {
+    public:
+        explicit EpollBackend(TallyServer* server) : server(server) {}
 
-        unsigned char key[32], iv[16];
-        RAND_bytes(key, sizeof(key));
-        RAND_bytes(iv, sizeof(iv));
+        const char* name() const override { return "epoll"; }
 
-        if (EVP_EncryptInit_ex(ctx, EVP_aes_256_cbc(), NULL, key, iv) != 1) {
-            EVP_CIPHER_CTX_free(ctx);
-            return "";
-        }
-
-        std::vector<unsigned char> ciphertext(message.size() + EVP_MAX_BLOCK_LENGTH);
-        int len1 = 0, len2 = 0;
+        void run() override {
+            for (int fd : server->listenSockets) {
+                if (!EventLoop::setNonBlocking(fd)) {
+                    std::cerr << "Failed to make listening socket non-blocking" << std::endl;
+                    return;
+                }
+            }
 
-        if (EVP_EncryptUpdate(ctx, ciphertext.data(), &len1,
-                            (const unsigned char*)message.c_str(), message.size()) != 1) {
-            EVP_CIPHER_CTX_free(ctx);
-            return "";
-        }
+            for (size_t i = 0; i < server->acceptors.size(); i++) {
+                auto context = std::make_unique<LoopContext>();
+                context->loop = std::make_unique<EventLoop>();
+                if (!context->loop->valid()) {
+                    std::cerr << "Failed to create event loop" << std::endl;
+                    break;
+                }
+                int listener = server->acceptors[i]->listener;
+                context->listenSocket = server->listenSockets[listener];
+                context->acceptStats = &server->acceptors[i]->stats;
+                context->acceptor = std::make_unique<LoopAcceptor>(server, context.get(), context->listenSocket, false);
+                // EPOLLEXCLUSIVE avoids waking every loop sharing a listener for each incoming connection
+                if (!context->loop->add(context->listenSocket, EPOLLIN | EPOLLET | EPOLLEXCLUSIVE, context->acceptor.get())) {
+                    std::cerr << "Failed to register listening socket: " << SOCKET_ERROR_CODE << std::endl;
+                    break;
+                }
+                // Every loop also drains the TLS listener paired with its plaintext one
+                if (server->tlsContext) {
+                    context->tlsListenSocket = server->listenSockets[server->plainListeners + listener];
+                    context->tlsAcceptor = std::make_unique<LoopAcceptor>(server, context.get(), context->tlsListenSocket, true);
+                    if (!context->loop->add(context->tlsListenSocket, EPOLLIN | EPOLLET | EPOLLEXCLUSIVE,
+                                            context->tlsAcceptor.get())) {
+                        std::cerr << "Failed to register TLS listening socket: " << SOCKET_ERROR_CODE << std::endl;
+                        break;
+                    }
+                }
+                std::lock_guard<std::mutex> lock(loopsMutex);
+                loops.push_back(std::move(context));
+            }
 
-        if (EVP_EncryptFinal_ex(ctx, ciphertext.data() + len1, &len2) != 1) {
-            EVP_CIPHER_CTX_free(ctx);
-            return "";
+            for (size_t i = 0; i < loops.size(); i++) {
+                LoopContext* raw = loops[i].get();
+                loops[i]->thread = std::thread([this, raw, i]() {
+                    if (server->options.pinCpus) Listener::pinCurrentThread((int)i);
+                    raw->loop->run((int)raw->deadlines.tick().count(), [raw]() { raw->deadlines.advance(); });
+                });
+            }
+            for (auto& context : loops) {
+                if (context->thread.joinable()) context->thread.join();
+            }
+            std::lock_guard<std::mutex> lock(loopsMutex);
+            for (auto& context : loops) {
+                for (auto& entry : context->connections) {
+                    CLOSE_SOCKET(entry.first);
+                }
+            }
+            loops.clear();
         }
 
-        EVP_CIPHER_CTX_free(ctx);
-
-        // Store session key for this peer
-        session_keys[peer_id] = std::string((char*)key, sizeof(key));
-
-        // Return IV + ciphertext
-        std::string result((char*)iv, sizeof(iv));
-        result += std::string((char*)ciphertext.data(), len1 + len2);
-        return result;
-    }
-
-    std::string decryptMessage(const std::string& encrypted, const std::string& peer_id) {
-        if (encrypted.size() < 16 || session_keys.find(peer_id) == session_keys.end()) {
-            return "";
+        void stop() override {
+            std::lock_guard<std::mutex> lock(loopsMutex);
+            for (auto& context : loops) {
+                context->loop->stop();
+            }
         }
 
-        EVP_CIPHER_CTX* ctx = EVP_CIPHER_CTX_new();
-        if (!ctx) return "";
+    private:
+        TallyServer* server;
+        std::mutex loopsMutex; // run() builds and clears the loops while stop() may walk them
+        std::vector<std::unique_ptr<LoopContext>> loops;
+    };
 
-        const std::string& key_str = session_keys[peer_id];
-        const unsigned char* iv = (const unsigned char*)encrypted.data();
-        const unsigned char* ciphertext = (const unsigned char*)encrypted.data() + 16;
-        int ciphertext_len = encrypted.size() - 16;
+    // One io_uring ring per loop thread. Completions carry the object they belong to in
+    // user_data, with the operation in the low bits (objects are 8-byte aligned).
+    enum RingOp : uint64_t { OpAccept, OpWake, OpRecv, OpSend, OpFileRead, OpFileSend };
+    static constexpr uint64_t RING_OP_MASK = 7;
 
-        if (EVP_DecryptInit_ex(ctx, EVP_aes_256_cbc(), NULL,
-                             (const unsigned char*)key_str.c_str(), iv) != 1) {
-            EVP_CIPHER_CTX_free(ctx);
-            return "";
-        }
+    static uint64_t ringTag(const void* owner, RingOp op) { return (uint64_t)(uintptr_t)owner | op; }
 
-        std::vector<unsigned char> plaintext(ciphertext_len + EVP_MAX_BLOCK_LENGTH);
-        int len1 = 0, len2 = 0;
+    class RingConnection;
 
-        if (EVP_DecryptUpdate(ctx, plaintext.data(), &len1, ciphertext, ciphertext_len) != 1) {
-            EVP_CIPHER_CTX_free(ctx);
-            return "";
-        }
+    struct RingContext {
+        std::unique_ptr<IoUring> ring;
+        TimerWheel deadlines; // declared before connections, which disarm their timers on destruction
+        std::unordered_map<int, std::unique_ptr<RingConnection>> connections;
+        std::vector<unsigned> freeFileBuffers; // registered buffers not staging a file read
+        std::thread thread;
+        int listenSocket = -1;
+        AcceptStats* acceptStats = nullptr;
+        int wakeFd = -1;
+        uint64_t wakeValue = 0;
+        bool multishotAccept = true;
 
-        if (EVP_DecryptFinal_ex(ctx, plaintext.data() + len1, &len2) != 1) {
-            EVP_CIPHER_CTX_free(ctx);
-            return "";
+        // Make room for `count` submission entries, flushing the queue to the kernel if needed.
+        // Linked entries must be reserved together: a flush between them would split the link.
+        void reserve(unsigned count) {
+            while (ring->spaceLeft() < count) ring->submit();
         }
 
-        EVP_CIPHER_CTX_free(ctx);
-        return std::string((char*)plaintext.data(), len1 + len2);
-    }
-
-    bool authenticatePeer(const std::string& peer_id, const std::string& challenge,
-                         const std::string& signature) {
-        // Simple challenge-response authentication
-        auto it = peers.find(peer_id);
-        if (it == peers.end()) return false;
-
-        // In real implementation, verify signature using peer's public key
-        // For demo, use simple hash comparison with a static secret
-        std::string data = challenge + "auth_secret";
-        unsigned char hash[SHA256_DIGEST_LENGTH];
-        SHA256((const unsigned char*)data.c_str(), data.size(), hash);
-
-        std::stringstream ss;
-        for(int i = 0; i < SHA256_DIGEST_LENGTH; i++) {
-            ss << std::hex << std::setw(2) << std::setfill('0') << (int)hash[i];
+        io_uring_sqe* sqe() {
+            reserve(1);
+            return ring->sqe();
         }
-        std::string expected = ss.str();
+    };
 
-        return signature == expected;
-    }
+    // Completion-driven connection on an io_uring ring. Receives land in the ring's provided
+    // buffers; responses leave as one SENDMSG over the gathered byte runs, and file ranges as
+    // a READ_FIXED into a registered buffer linked to the SEND of that buffer, so each chunk
+    // costs one submission and no syscall of its own. Only one send is in flight at a time,
+    // and requests that arrive meanwhile are parsed once it completes, so the queue is
+    // never appended to under the kernel.
+    class RingConnection : public LoopSession {
+    public:
+        static constexpr unsigned FILE_CHUNK = 64 * 1024; // file bytes read and sent per submission pair
 
-public:
-    PeerNetwork(const std::string& ip = "10.0.0.1") : node_ip(ip), node_id(generateNodeId()) {
-        generateKeyPair();
-    }
+        RingConnection(TallyServer* server, RingContext* context, int fd, const std::string& clientIP)
+            : LoopSession(server, context->deadlines, fd, clientIP), context(context) {}
 
-    bool startNetwork() {
-        std::cout << "🌐 Starting peer network as node: " << node_id << std::endl;
-        std::cout << "📡 Node IP: " << node_ip << std::endl;
+        ~RingConnection() override { releaseFileBuffer(); }
 
-        if (!tunnel.start()) {
-            return false;
+        void start() {
+            armRecv();
+            updateDeadline();
         }
 
-        // Add self as first peer
-        addPeer(node_id, node_ip, "self-public-key");
-
-        return true;
-    }
-
-    void stopNetwork() {
-        tunnel.stop();
-        std::cout << "🌐 Peer network stopped" << std::endl;
-    }
-
-    void addPeer(const std::string& peer_id, const std::string& peer_ip, const std::string& pubkey = "") {
-        std::lock_guard<std::mutex> lock(peers_mutex);
-        peers.emplace(peer_id, SecurePeer(peer_id, peer_ip, pubkey));
-        tunnel.addPeer(peer_ip);
-    }
-
-    void removePeer(const std::string& peer_id) {
-        std::lock_guard<std::mutex> lock(peers_mutex);
-        auto it = peers.find(peer_id);
-        if (it != peers.end()) {
-            tunnel.removePeer(it->second.getIp());
-            peers.erase(it);
+        void onCompletion(RingOp op, const io_uring_cqe& cqe) {
+            inFlight--;
+            if (closing) {
+                if (op == OpRecv) context->ring->recycleBuffer(cqe);
+                if (inFlight == 0) finish();
+                return;
+            }
+            bool open = true;
+            switch (op) {
+                case OpRecv: open = onRecv(cqe); break;
+                case OpSend: open = onSend(cqe); break;
+                case OpFileRead: break; // a short or failed read cancels the linked send, handled there
+                case OpFileSend: open = onFileSend(cqe); break;
+                default: break;
+            }
+            if (open) updateDeadline();
+        }
+
+        // Shut the socket down so every operation still in flight completes, then free the
+        // connection once the last one has
+        void closeConnection() override {
+            if (closing) return;
+            closing = true;
+            cancel();
+            shutdown(fd, SHUT_RDWR);
+            if (inFlight == 0) finish();
+        }
+
+    private:
+        RingContext* context;
+        int inFlight = 0;
+        bool receiving = false;
+        bool sending = false;
+        bool closing = false;
+        msghdr message{};
+        iovec iov[SendQueue::MAX_IOV];
+        size_t fileChunk = 0;  // bytes of the front file range read for the send in flight
+        size_t fileSent = 0;
+        int fileBuffer = -1;   // registered buffer staging the chunk, -1 for ownBuffer
+        std::unique_ptr<char[]> ownBuffer;
+
+        void finish() {
+            CLOSE_SOCKET(fd);
+            server->admission.releaseConnection();
+            context->connections.erase(fd); // destroys this
+        }
+
+        void armRecv() {
+            if (receiving || closeAfterFlush || peerClosed || output.pendingBytes() > MAX_PENDING_OUTPUT) return;
+            io_uring_sqe* sqe = context->sqe();
+            sqe->opcode = IORING_OP_RECV;
+            sqe->fd = fd;
+            sqe->flags = IOSQE_BUFFER_SELECT;
+            sqe->buf_group = context->ring->bufferGroup();
+            sqe->user_data = ringTag(this, OpRecv);
+            receiving = true;
+            inFlight++;
+        }
+
+        bool onRecv(const io_uring_cqe& cqe) {
+            receiving = false;
+            if (cqe.res == -ENOBUFS) { // every provided buffer was taken; they are back by now
+                armRecv();
+                return true;
+            }
+            if (cqe.res < 0) {
+                closeConnection();
+                return false;
+            }
+            if (cqe.res == 0) {
+                peerClosed = true; // answer what already arrived, then close
+            } else {
+                input.append(context->ring->selectedBuffer(cqe), cqe.res);
+                context->ring->recycleBuffer(cqe);
+            }
+            return advance();
         }
-    }
 
-    std::vector<SecurePeer> getPeers() const {
-        std::lock_guard<std::mutex> lock(peers_mutex);
-        std::vector<SecurePeer> result;
-        for (const auto& pair : peers) {
-            result.push_back(pair.second);
+        // Parse what arrived, send what is queued and keep reading; false if closed
+        bool advance() {
+            if (sending) return true; // resumed when the send completes
+            processRequests();
+            if (output.empty()) {
+                if (closeAfterFlush || peerClosed) {
+                    closeConnection();
+                    return false;
+                }
+            } else {
+                startSend();
+            }
+            armRecv();
+            return true;
         }
-        return result;
-    }
 
-    std::string getNodeId() const { return node_id; }
-    std::string getNodeIp() const { return node_ip; }
+        void startSend() {
+            int file;
+            off_t offset;
+            size_t remaining;
+            sending = true;
+            if (!output.frontFile(&file, &offset, &remaining)) {
+                bool fileFollows = false;
+                message.msg_iov = iov;
+                message.msg_iovlen = output.gather(iov, SendQueue::MAX_IOV, &fileFollows);
+                io_uring_sqe* sqe = context->sqe();
+                sqe->opcode = IORING_OP_SENDMSG;
+                sqe->fd = fd;
+                sqe->addr = (uint64_t)(uintptr_t)&message;
+                sqe->msg_flags = MSG_NOSIGNAL | MSG_WAITALL | (fileFollows ? MSG_MORE : 0);
+                sqe->user_data = ringTag(this, OpSend);
+                inFlight++;
+                return;
+            }
 
-    void cleanupExpiredPeers(int timeout_sec = 300) {
-        std::lock_guard<std::mutex> lock(peers_mutex);
-        for (auto it = peers.begin(); it != peers.end(); ) {
-            if (it->second.isExpired(timeout_sec) && it->first != node_id) {
-                tunnel.removePeer(it->second.getIp());
-                session_keys.erase(it->first); // Cleanup session key
-                it = peers.erase(it);
-            } else {
-                ++it;
+            fileChunk = std::min<size_t>(remaining, FILE_CHUNK);
+            fileSent = 0;
+            char* buffer = acquireFileBuffer();
+            context->reserve(2);
+            io_uring_sqe* read = context->sqe();
+            read->opcode = fileBuffer >= 0 ? IORING_OP_READ_FIXED : IORING_OP_READ;
+            read->fd = file;
+            read->addr = (uint64_t)(uintptr_t)buffer;
+            read->len = (uint32_t)fileChunk;
+            read->off = (uint64_t)offset;
+            if (fileBuffer >= 0) read->buf_index = (uint16_t)fileBuffer;
+            read->flags = IOSQE_IO_LINK;
+            read->user_data = ringTag(this, OpFileRead);
+            sendFileChunk(buffer, fileChunk);
+            inFlight++;
+        }
+
+        void sendFileChunk(char* buffer, size_t length) {
+            io_uring_sqe* sqe = context->sqe();
+            sqe->opcode = IORING_OP_SEND;
+            sqe->fd = fd;
+            sqe->addr = (uint64_t)(uintptr_t)buffer;
+            sqe->len = (uint32_t)length;
+            sqe->msg_flags = MSG_NOSIGNAL | MSG_WAITALL | (length < output.pendingBytes() ? MSG_MORE : 0);
+            sqe->user_data = ringTag(this, OpFileSend);
+            inFlight++;
+        }
+
+        bool onSend(const io_uring_cqe& cqe) {
+            sending = false;
+            if (cqe.res < 0) {
+                closeConnection();
+                return false;
             }
+            output.consume(cqe.res);
+            return advance();
         }
-    }
 
-    // Secure communication methods
-    std::string sendSecureMessage(const std::string& peer_id, const std::string& message) {
-        std::lock_guard<std::mutex> lock(peers_mutex);
-        if (peers.find(peer_id) == peers.end()) {
-            return "";
+        bool onFileSend(const io_uring_cqe& cqe) {
+            // -ECANCELED: the linked read came up short (the file shrank) or failed
+            if (cqe.res <= 0) {
+                closeConnection();
+                return false;
+            }
+            fileSent += cqe.res;
+            if (fileSent < fileChunk) {
+                sendFileChunk(fileBufferData() + fileSent, fileChunk - fileSent);
+                return true;
+            }
+            sending = false;
+            releaseFileBuffer();
+            output.consumeFile(fileChunk);
+            return advance();
+        }
+
+        char* acquireFileBuffer() {
+            if (!context->freeFileBuffers.empty()) {
+                fileBuffer = (int)context->freeFileBuffers.back();
+                context->freeFileBuffers.pop_back();
+            } else if (!ownBuffer) {
+                ownBuffer.reset(new char[FILE_CHUNK]); // every registered buffer is busy
+            }
+            return fileBufferData();
         }
-        return encryptMessage(message, peer_id);
-    }
 
-    std::string receiveSecureMessage(const std::string& peer_id, const std::string& encrypted) {
-        std::lock_guard<std::mutex> lock(peers_mutex);
-        if (peers.find(peer_id) == peers.end()) {
-            return "";
+        char* fileBufferData() const {
+            return fileBuffer >= 0 ? context->ring->fixedBuffer(fileBuffer) : ownBuffer.get();
         }
-        return decryptMessage(encrypted, peer_id);
-    }
-
-    std::string getPublicKey() const {
-        return public_key;
-    }
-
-    std::string generateAuthChallenge(const std::string& peer_id) {
-        // Generate random challenge for authentication
-        unsigned char challenge[32];
-        RAND_bytes(challenge, sizeof(challenge));
-        return std::string((char*)challenge, sizeof(challenge));
-    }
 
-    bool verifyPeerAuthentication(const std::string& peer_id,
-                                const std::string& challenge,
-                                const std::string& response) {
-        return authenticatePeer(peer_id, challenge, response);
-    }
-
-    // Network discovery and management
-    void broadcastDiscovery() {
-        std::lock_guard<std::mutex> lock(peers_mutex);
-        std::cout << "📡 Broadcasting network discovery..." << std::endl;
+        void releaseFileBuffer() {
+            if (fileBuffer < 0) return;
+            context->freeFileBuffers.push_back((unsigned)fileBuffer);
+            fileBuffer = -1;
+        }
+    };
 
-        // Simulate discovering some peers for demo purposes
-        std::vector<std::string> simulated_peers = {
-            "discovered_peer_1", "discovered_peer_2", "discovered_peer_3"
-        };
+    // io_uring rings: like the epoll backend one loop thread per acceptor, but accept is
+    // one multishot request per ring and every read and write is a submission, batched
+    // into a single io_uring_enter per loop iteration
+    class UringBackend : public IoBackend {
+    public:
+        explicit UringBackend(TallyServer* server) : server(server) {}
+
+        const char* name() const override { return "uring"; }
+
+        void run() override {
+            for (size_t i = 0; i < server->acceptors.size(); i++) {
+                auto context = std::make_unique<RingContext>();
+                context->listenSocket = server->listenSockets[server->acceptors[i]->listener];
+                context->acceptStats = &server->acceptors[i]->stats;
+                context->wakeFd = eventfd(0, EFD_CLOEXEC);
+                if (context->wakeFd < 0) {
+                    std::cerr << "Failed to create ring wakeup eventfd" << std::endl;
+                    break;
+                }
+                std::lock_guard<std::mutex> lock(ringsMutex);
+                rings.push_back(std::move(context));
+            }
 
-        for (const auto& peer_id : simulated_peers) {
-            std::string peer_ip = "10.0.0." + std::to_string(rand() % 50 + 10);
-            if (peers.find(peer_id) == peers.end()) {
-                addPeer(peer_id, peer_ip, "discovered_public_key");
-                std::cout << "➕ Discovered peer: " << peer_id << " (" << peer_ip << ")" << std::endl;
+            for (size_t i = 0; i < rings.size(); i++) {
+                RingContext* raw = rings[i].get();
+                rings[i]->thread = std::thread([this, raw, i]() {
+                    if (server->options.pinCpus) Listener::pinCurrentThread((int)i);
+                    runRing(raw);
+                });
+            }
+            for (auto& context : rings) {
+                if (context->thread.joinable()) context->thread.join();
+            }
+            std::lock_guard<std::mutex> lock(ringsMutex);
+            for (auto& context : rings) {
+                close(context->wakeFd);
             }
+            rings.clear();
         }
-    }
-
-    void performNetworkScan() {
-        std::lock_guard<std::mutex> lock(peers_mutex);
-        std::cout << "🔍 Performing network scan..." << std::endl;
-
-        // Simulate network scanning by adding some random peers
-        for (int i = 0; i < 3; i++) {
-            std::string peer_id = "scanned_peer_" + std::to_string(rand() % 1000);
-            std::string peer_ip = "10.0.1." + std::to_string(rand() % 50 + 10);
 
-            if (peers.find(peer_id) == peers.end()) {
-                addPeer(peer_id, peer_ip, "scanned_public_key");
-                std::cout << "📡 Found peer: " << peer_id << " (" << peer_ip << ")" << std::endl;
+        void stop() override {
+            std::lock_guard<std::mutex> lock(ringsMutex);
+            for (auto& context : rings) {
+                uint64_t one = 1;
+                ssize_t ignored = write(context->wakeFd, &one, sizeof(one));
+                (void)ignored;
             }
         }
-    }
 
-    void manageNetworkTopology() {
-        std::lock_guard<std::mutex> lock(peers_mutex);
-        std::cout << "🌐 Managing network topology..." << std::endl;
+    private:
+        // Submission and completion queue depth per ring, and the buffers each ring owns
+        static constexpr unsigned RING_ENTRIES = 4096;
+        static constexpr unsigned RECV_BUFFERS = 1024; // provided receive buffers
+        static constexpr unsigned RECV_BUFFER_SIZE = 8192;
+        static constexpr unsigned FILE_BUFFERS = 64;   // registered file staging buffers
 
-        // Perform network health checks and optimize connections
-        int active_peers = 0;
-        int authenticated_peers = 0;
+        TallyServer* server;
+        std::mutex ringsMutex; // as in EpollBackend
+        std::vector<std::unique_ptr<RingContext>> rings;
 
-        for (const auto& pair : peers) {
-            if (!pair.second.isExpired(600)) { // 10 minute timeout
-                active_peers++;
+        void runRing(RingContext* context) {
+            // Created here: the ring only accepts submissions from the thread that set it up
+            context->ring = std::make_unique<IoUring>(RING_ENTRIES);
+            if (!context->ring->valid() || !context->ring->setupProvidedBuffers(0, RECV_BUFFERS, RECV_BUFFER_SIZE)) {
+                std::cerr << "Failed to set up io_uring: " << SOCKET_ERROR_CODE << std::endl;
+                return;
             }
-            if (pair.second.isAuthenticated()) {
-                authenticated_peers++;
+            if (context->ring->registerBuffers(FILE_BUFFERS, RingConnection::FILE_CHUNK)) {
+                for (unsigned i = 0; i < FILE_BUFFERS; i++) context->freeFileBuffers.push_back(i);
+            }
+            armAccept(context);
+            armWake(context);
+
+            while (server->running) {
+                int result = context->ring->submitAndWait(context->deadlines.tick());
+                if (result < 0 && result != -EINTR && result != -ETIME && result != -EBUSY) {
+                    std::cerr << "io_uring_enter failed: " << -result << std::endl;
+                    break;
+                }
+                context->ring->forEachCompletion([this, context](const io_uring_cqe& cqe) {
+                    void* owner = (void*)(uintptr_t)(cqe.user_data & ~RING_OP_MASK);
+                    RingOp op = (RingOp)(cqe.user_data & RING_OP_MASK);
+                    if (op == OpAccept) onAccept(context, cqe);
+                    else if (op == OpWake) armWake(context);
+                    else static_cast<RingConnection*>(owner)->onCompletion(op, cqe);
+                });
+                context->deadlines.advance();
+            }
+            // Closing the ring cancels whatever is still in flight before the connections go
+            context->ring.reset();
+            for (auto& entry : context->connections) {
+                CLOSE_SOCKET(entry.first);
+            }
+            context->connections.clear();
+        }
+
+        void armAccept(RingContext* context) {
+            io_uring_sqe* sqe = context->sqe();
+            sqe->opcode = IORING_OP_ACCEPT;
+            sqe->fd = context->listenSocket;
+            if (context->multishotAccept) sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+            sqe->accept_flags = SOCK_CLOEXEC;
+            sqe->user_data = ringTag(context, OpAccept);
+        }
+
+        void armWake(RingContext* context) {
+            if (!server->running) return;
+            io_uring_sqe* sqe = context->sqe();
+            sqe->opcode = IORING_OP_READ;
+            sqe->fd = context->wakeFd;
+            sqe->addr = (uint64_t)(uintptr_t)&context->wakeValue;
+            sqe->len = sizeof(context->wakeValue);
+            sqe->user_data = ringTag(context, OpWake);
+        }
+
+        void onAccept(RingContext* context, const io_uring_cqe& cqe) {
+            // Kernels before 5.19 reject multishot accepts; take one connection per submission there
+            if (cqe.res == -EINVAL && context->multishotAccept) context->multishotAccept = false;
+            // A multishot accept keeps going until the kernel drops it (error, overflow)
+            if (!(cqe.flags & IORING_CQE_F_MORE) && server->running) armAccept(context);
+            if (cqe.res < 0) {
+                if (cqe.res != -ECANCELED && cqe.res != -EINVAL && server->running) {
+                    std::cerr << "Accept failed: " << -cqe.res << std::endl;
+                }
+                return;
             }
-        }
 
-        std::cout << "📊 Network stats: " << active_peers << " active peers, "
-                  << authenticated_peers << " authenticated" << std::endl;
-    }
+            int clientSocket = cqe.res;
+            context->acceptStats->record();
+            if (!server->admission.tryAdmitConnection(0)) {
+                server->admission.rejectConnection(clientSocket);
+                CLOSE_SOCKET(clientSocket);
+                return;
+            }
+            sockaddr_in clientAddr{};
+            socklen_t clientAddrLen = sizeof(clientAddr);
+            getpeername(clientSocket, (sockaddr*)&clientAddr, &clientAddrLen);
+            std::string clientIP = inet_ntoa(clientAddr.sin_addr);
+            server->trackSession(clientIP);
 
-    void establishSecureSession(const std::string& peer_id, const std::string& peer_pubkey) {
-        std::lock_guard<std::mutex> lock(peers_mutex);
-        auto it = peers.find(peer_id);
-        if (it != peers.end()) {
-            // Store peer's public key for future authentication
-            it->second.setAuthenticated(true);
-            std::cout << "🔐 Secure session established with peer: " << peer_id << std::endl;
+            auto connection = std::make_unique<RingConnection>(server, context, clientSocket, clientIP);
+            RingConnection* raw = connection.get();
+            context->connections[clientSocket] = std::move(connection);
+            raw->start();
         }
-    }
-
-    // Public network management methods
-    void discoverPeers() {
-        broadcastDiscovery();
-    }
-
-    void scanNetwork() {
-        performNetworkScan();
-    }
-
-    void optimizeTopology() {
-        manageNetworkTopology();
-    }
-
-    std::string getNetworkStatus() const {
-        std::lock_guard<std::mutex> lock(peers_mutex);
-        std::stringstream ss;
-        ss << "🌐 Network Status:\n";
-        ss << "Node ID: " << node_id << "\n";
-        ss << "Node IP: " << node_ip << "\n";
-        ss << "Total Peers: " << peers.size() << "\n";
+    };
 
-        int active = 0, authenticated = 0;
-        for (const auto& pair : peers) {
-            if (!pair.second.isExpired(600)) active++;
-            if (pair.second.isAuthenticated()) authenticated++;
+    // Threads-model connection between pool tasks: what the next worker needs to carry on
+    // where the last one stopped. The socket is closed when the last reference goes, by
+    // whichever thread drops it.
+    class PooledConnection : public EventLoop::Handler, public TimerWheel::Timer {
+    public:
+        PooledConnection(TallyServer* server, int fd, const std::string& clientIP, TlsContext* tlsContext)
+            : server(server), fd(fd), clientIP(clientIP),
+              headerDeadline(std::chrono::steady_clock::now() + server->phaseTimeout(ConnectionPhase::Header)) {
+            if (tlsContext) tls = std::make_unique<TlsSession>(*tlsContext, fd);
+        }
+
+        ~PooledConnection() override {
+            if (tls) tls->shutdown();
+            CLOSE_SOCKET(fd);
+            server->admission.releaseConnection();
+        }
+
+        // Waiter thread: the socket is ready, so a worker can take over again
+        void onEvents(uint32_t) override { server->connectionWaiter->resume(fd); }
+
+        TallyServer* server;
+        int fd;
+        std::string clientIP;
+        std::unique_ptr<TlsSession> tls;
+        std::string input;
+        HttpParser parser{MAX_REQUEST_SIZE, MAX_REQUEST_SIZE};
+        SendQueue output; // reused across batches so its head buffer is recycled
+        RequestArena arena;
+        int served = 0;
+        bool closeAfterFlush = false;
+        // The first head's deadline (which covers a TLS handshake) runs from the accept,
+        // every later one from the head's first byte
+        std::chrono::steady_clock::time_point headerDeadline;
+
+        // What the connection waits for while parked
+        ConnectionPhase phase = ConnectionPhase::Header;
+        std::chrono::milliseconds wait{0};
+        uint32_t waitEvents = EPOLLIN;
+
+    protected:
+        // Waiter thread: the phase deadline passed while parked
+        void onTimeout() override {
+            server->countTimeout(phase);
+            server->connectionWaiter->expire(fd);
         }
-
-        ss << "Active Peers: " << active << "\n";
-        ss << "Authenticated Peers: " << authenticated << "\n";
-        ss << "Session Keys: " << session_keys.size() << "\n";
-
-        return ss.str();
-    }
-};
-
-// Tally System Core Classes
-class TallyLedger {
-private:
-    struct TallyTransaction {
-        std::string hash;
-        std::string from;
-        std::string to;
-        int amount;
-        time_t timestamp;
-        std::string narrative; // The King's Reckoning story segments
     };
 
-    std::vector<TallyTransaction> ledger;
-    std::unordered_map<std::string, int> balances;
+    // Threads model: connections waiting for input (a TLS handshake flight, the rest of a
+    // request, or the next request on a keep-alive connection) are parked here instead
+    // of keeping a pool worker in recv. One thread watches them with epoll under their
+    // phase deadlines and submits each back to the pool once its socket is ready.
+    class ConnectionWaiter : public EventLoop::Handler {
+    public:
+        explicit ConnectionWaiter(TallyServer* server)
+            : server(server), wakeFd(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)) {}
 
-public:
-    TallyLedger() {
-        // Initialize with genesis tallies
-        balances["user"] = 1;
-        balances["network"] = 1;
-
-        // Add genesis transaction
-        TallyTransaction genesis{
-            "genesis_hash", "system", "user", 1, time(nullptr), "The King's first tally - sovereignty granted"
-        };
-        ledger.push_back(genesis);
-
-        TallyTransaction networkGenesis{
-            "network_genesis", "system", "network", 1, time(nullptr), "Network tally created - collective power"
-        };
-        ledger.push_back(networkGenesis);
-    }
-
-    bool transfer(const std::string& from, const std::string& to, int amount, const std::string& narrative = "") {
-        if (balances[from] < amount) return false;
-
-        std::string hash = generateHash(from + to + std::to_string(amount) + narrative + std::to_string(time(nullptr)));
-
-        TallyTransaction tx{hash, from, to, amount, time(nullptr), narrative};
-        ledger.push_back(tx);
-
-        balances[from] -= amount;
-        balances[to] += amount;
-
-        return true;
-    }
+        ~ConnectionWaiter() {
+            stop();
+            if (wakeFd >= 0) close(wakeFd);
+        }
 
-    int getBalance(const std::string& account) {
-        return balances[account];
-    }
+        ConnectionWaiter(const ConnectionWaiter&) = delete;
+        ConnectionWaiter& operator=(const ConnectionWaiter&) = delete;
 
-    bool combineTallies() {
-        if (balances["user"] == 1 && balances["network"] == 1) {
-            // Create combined sovereignty state
-            transfer("user", "collective", 1, "Individual sovereignty surrendered for collective power");
-            transfer("network", "collective", 1, "Network power merged into collective decision-making");
+        bool start() {
+            if (!loop.valid() || wakeFd < 0 || !loop.add(wakeFd, EPOLLIN, this)) return false;
+            thread = std::thread([this]() {
+                loop.run((int)deadlines.tick().count(), [this]() { deadlines.advance(); });
+            });
             return true;
         }
-        return false;
-    }
 
-    bool separateTallies() {
-        if (balances["collective"] == 2) {
-            transfer("collective", "user", 1, "Individual sovereignty restored");
-            transfer("collective", "network", 1, "Network autonomy reestablished");
+        // Any thread: watch `connection` for its waitEvents until its wait runs out. False
+        // once stopping; the caller then drops the connection, which closes it.
+        bool park(std::shared_ptr<PooledConnection> connection) {
+            {
+                std::lock_guard<std::mutex> lock(arrivingMutex);
+                if (stopping) return false;
+                arriving.push_back(std::move(connection));
+            }
+            uint64_t one = 1;
+            ssize_t ignored = write(wakeFd, &one, sizeof(one));
+            (void)ignored;
             return true;
         }
-        return false;
-    }
 
-    std::string generateHash(const std::string& data) {
-        unsigned char hash[SHA256_DIGEST_LENGTH];
-        EVP_MD_CTX* context = EVP_MD_CTX_new();
+        // Close every parked connection and refuse new ones
+        void stop() {
+            {
+                std::lock_guard<std::mutex> lock(arrivingMutex);
+                if (stopping) return;
+                stopping = true;
+            }
+            loop.stop();
+            if (thread.joinable()) thread.join();
+            parked.clear();
+            arriving.clear();
+        }
+
+        // Waiter thread: hand a ready connection back to the pool
+        void resume(int fd) {
+            auto it = parked.find(fd);
+            std::shared_ptr<PooledConnection> connection = std::move(it->second);
+            parked.erase(it);
+            loop.remove(fd, connection.get());
+            connection->cancel();
+            server->workerPool->submit([server = server, connection]() { server->serveConnection(connection); });
+        }
+
+        // Waiter thread: drop a connection whose deadline passed, closing it
+        void expire(int fd) {
+            auto it = parked.find(fd);
+            loop.remove(fd, it->second.get());
+            parked.erase(it);
+        }
+
+    private:
+        TallyServer* server;
+        EventLoop loop;
+        TimerWheel deadlines; // declared before parked, whose connections disarm their timers on destruction
+        std::unordered_map<int, std::shared_ptr<PooledConnection>> parked;
+        std::mutex arrivingMutex;
+        std::vector<std::shared_ptr<PooledConnection>> arriving; // parked by workers, not yet registered
+        bool stopping = false;
+        int wakeFd;
+        std::thread thread;
+
+        // The wakeup eventfd: register what the workers parked since the last wakeup
+        void onEvents(uint32_t) override {
+            uint64_t value;
+            while (read(wakeFd, &value, sizeof(value)) > 0) {}
+            std::vector<std::shared_ptr<PooledConnection>> batch;
+            {
+                std::lock_guard<std::mutex> lock(arrivingMutex);
+                batch.swap(arriving);
+            }
+            for (auto& connection : batch) {
+                // Level-triggered, so input that arrived before the registration still wakes it
+                if (!loop.add(connection->fd, connection->waitEvents, connection.get())) continue;
+                deadlines.schedule(*connection, connection->wait);
+                int fd = connection->fd;
+                parked[fd] = std::move(connection);
+            }
+        }
+    };
+
+    // Blocking accept threads handing every connection to the worker pool
+    class ThreadsBackend : public IoBackend {
+    public:
+        explicit ThreadsBackend(TallyServer* server) : server(server) {}
 
-        if (!context) return "hash_error";
+        const char* name() const override { return "threads"; }
 
-        if (EVP_DigestInit_ex(context, EVP_sha256(), NULL) &&
-            EVP_DigestUpdate(context, data.c_str(), data.size()) &&
-            EVP_DigestFinal_ex(context, hash, NULL)) {
+        void run() override {
+            server->connectionWaiter = std::make_unique<ConnectionWaiter>(server);
+            if (!server->connectionWaiter->start()) {
+                std::cerr << "Failed to start the connection waiter" << std::endl;
+                return;
+            }
+            server->workerPool = std::make_unique<WorkStealingPool>(server->workerThreadCount());
 
-            std::stringstream ss;
-            for(int i = 0; i < SHA256_DIGEST_LENGTH; i++) {
-                ss << std::hex << std::setw(2) << std::setfill('0') << (int)hash[i];
+            // Acceptor 0 runs on this thread, the rest get their own accept threads
+            std::vector<std::thread> acceptThreads;
+            for (size_t i = 1; i < server->acceptors.size(); i++) {
+                acceptThreads.emplace_back([this, i]() { server->acceptLoop(i); });
             }
-            EVP_MD_CTX_free(context);
-            return ss.str();
+            server->acceptLoop(0);
+            for (auto& thread : acceptThreads) {
+                thread.join();
+            }
+
+            // Parked connections close now; tasks still queued find the waiter stopped and
+            // close theirs once answered
+            server->connectionWaiter->stop();
+            server->workerPool->shutdown();
         }
 
-        EVP_MD_CTX_free(context);
-        return "hash_error";
-    }
+        void stop() override {} // accept() fails once the listening sockets are shut down
 
-    std::string getLedgerSummary() const {
-        std::stringstream ss;
-        ss << "Tally Ledger Summary:\n";
-        ss << "User Balance: " << (balances.count("user") ? balances.at("user") : 0) << "\n";
-        ss << "Network Balance: " << (balances.count("network") ? balances.at("network") : 0) << "\n";
-        ss << "Collective Balance: " << (balances.count("collective") ? balances.at("collective") : 0) << "\n";
-        ss << "Total Transactions: " << ledger.size() << "\n";
-        return ss.str();
+    private:
+        TallyServer* server;
+    };
+
+    std::chrono::milliseconds phaseTimeout(ConnectionPhase phase) const {
+        switch (phase) {
+            case ConnectionPhase::Header: return std::chrono::seconds(options.headerTimeout);
+            case ConnectionPhase::Body: return std::chrono::seconds(options.bodyTimeout);
+            case ConnectionPhase::Write: return std::chrono::seconds(options.writeTimeout);
+            default: return std::chrono::seconds(options.keepAliveTimeout);
+        }
     }
-};
 
-class TallyServer {
-private:
-    int port;
-    std::atomic<bool> running;
-    std::string rootDir;
-    TallyLedger tallyLedger;
-    std::string pidFile;
-    std::string logFile;
 public:
     std::string currentUser;
     time_t startTime;
-    std::atomic<int> activeConnections;
+    AdmissionControl admission; // in-flight connection count and overload limits
     std::unordered_map<std::string, time_t> userSessions;
+    mutable std::mutex sessionsMutex;
     PeerNetwork peerNetwork;
 
     #ifdef _WIN32
@@ -666,26 +1116,6 @@ public:
     int serverSocket;
     #endif
 
-    std::string fingerprintContent(const std::string& content, const std::string& path) {
-        // Create cryptographic fingerprint of content with tally integration
-        std::string fingerprintData = content + path + std::to_string(time(nullptr));
-        std::string fingerprint = tallyLedger.generateHash(fingerprintData);
-
-        // Inject fingerprint as HTML comment
-        std::string fingerprintedContent = content;
-        size_t bodyPos = fingerprintedContent.find("<body");
-        if (bodyPos != std::string::npos) {
-            size_t bodyEnd = fingerprintedContent.find(">", bodyPos);
-            if (bodyEnd != std::string::npos) {
-                fingerprintedContent.insert(bodyEnd + 1,
-                    "\n<!-- TALLY FINGERPRINT: " + fingerprint + " -->\n"
-                    "<!-- SERVED BY: Economic Justice Tally Network -->\n");
-            }
-        }
-
-        return fingerprintedContent;
-    }
-
     std::string readFile(const std::string& filename) {
         std::ifstream file(filename, std::ios::binary);
         if (!file) return "";
@@ -696,10 +1126,21 @@ public:
     }
 
 public:
-    TallyServer(int port = 8080, const std::string& rootDir = ".")
+    TallyServer(int port = 8080, const std::string& rootDir = ".",
+                const TallyServerOptions& options = TallyServerOptions())
         : port(port), running(false), rootDir(rootDir), pidFile("/tmp/tally-server.pid"),
-          logFile("tally-server.log"), startTime(time(nullptr)), activeConnections(0),
+          logFile("tally-server.log"), options(options), startTime(time(nullptr)),
           serverSocket(INVALID_SOCKET), peerNetwork("10.0.0.1") {
+        assetCache = std::make_unique<StaticAssetCache>(rootDir, options.staticCacheMB * 1024 * 1024,
+                                                        options.compressionLevel > 0 ? 9 : 0);
+        std::vector<std::string> routeNames(std::size(TALLY_ROUTE_SPECS) + 1, "static");
+        for (const RouteSpec& spec : TALLY_ROUTE_SPECS) routeNames[spec.id] = spec.pattern;
+        requestMetrics = std::make_unique<RequestMetrics>(std::move(routeNames));
+        admission.setLimits({options.maxConnections, options.maxQueued, options.shedPercent, options.retryAfter});
+        keepAliveHeaders = "Connection: keep-alive\r\n"
+                           "Keep-Alive: timeout=" + std::to_string(options.keepAliveTimeout) +
+                           ", max=" + std::to_string(options.keepAliveRequests) + "\r\n";
+
         // Get current user
         struct passwd *pw = getpwuid(getuid());
         if (pw) {
@@ -707,6 +1148,14 @@ public:
         } else {
             currentUser = "unknown";
         }
+
+        if (!logger.open(logFile, options.logLevel, currentUser)) {
+            std::cerr << "⚠️  Cannot open log file " << logFile << ": " << strerror(errno) << std::endl;
+        }
+        if (!options.accessLogFile.empty() && !accessLog.open(options.accessLogFile)) {
+            std::cerr << "⚠️  Cannot open access log " << options.accessLogFile << ": " << strerror(errno) << std::endl;
+        }
+        Tracer::instance().enable(options.trace);
     }
 
     ~TallyServer() {
@@ -730,14 +1179,93 @@ public:
         return true;
     }
 
-    void logMessage(const std::string& message) {
-        std::ofstream logStream(logFile, std::ios::app);
-        if (logStream) {
-            auto now = std::chrono::system_clock::now();
-            auto now_time = std::chrono::system_clock::to_time_t(now);
-            logStream << std::put_time(std::localtime(&now_time), "%Y-%m-%d %H:%M:%S")
-                     << " [" << currentUser << "] " << message << std::endl;
-        }
+    void logMessage(const std::string& message, LogLevel level = LogLevel::Info) {
+        logger.log(level, message);
+    }
+
+    // Value of `name` in a query string, empty when absent; values are used undecoded
+    static std::string_view queryParam(std::string_view query, std::string_view name) {
+        while (!query.empty()) {
+            size_t end = query.find('&');
+            std::string_view pair = query.substr(0, end);
+            size_t equals = pair.find('=');
+            if (pair.substr(0, equals) == name) {
+                return equals == std::string_view::npos ? std::string_view() : pair.substr(equals + 1);
+            }
+            if (end == std::string_view::npos) break;
+            query.remove_prefix(end + 1);
+        }
+        return std::string_view();
+    }
+
+    // Prometheus text exposition: request metrics plus gauges sampled at scrape time
+    std::string getMetricsText() {
+        std::string out;
+        requestMetrics->render(out);
+
+        RequestMetrics::renderSample(out, "active_connections", "gauge", "Open client connections.",
+                                     admission.connections());
+        RequestMetrics::renderSample(out, "http_connections_rejected_total", "counter",
+                                     "Connections refused with 503 at accept time.", admission.rejectedConnections());
+        RequestMetrics::renderSample(out, "http_requests_shed_total", "counter",
+                                     "Non-priority requests answered 503 under load.", admission.shedRequests());
+        out += "# HELP http_connection_timeouts_total Connections closed for missing a deadline, by phase.\n"
+               "# TYPE http_connection_timeouts_total counter\n";
+        for (int phase = 0; phase < 4; phase++) {
+            out.append("http_connection_timeouts_total{phase=\"").append(PHASE_NAMES[phase]).append("\"} ")
+                .append(std::to_string(connectionTimeouts[phase].load(std::memory_order_relaxed))).append("\n");
+        }
+        if (tlsContext) {
+            out += "# HELP tls_handshakes_total TLS handshakes on the HTTPS port, by outcome.\n"
+                   "# TYPE tls_handshakes_total counter\n"
+                   "tls_handshakes_total{result=\"full\"} " + std::to_string(tlsContext->fullHandshakes()) + "\n"
+                   "tls_handshakes_total{result=\"resumed\"} " + std::to_string(tlsContext->resumedHandshakes()) + "\n"
+                   "tls_handshakes_total{result=\"failed\"} " + std::to_string(tlsContext->failedHandshakes()) + "\n";
+            RequestMetrics::renderSample(out, "tls_handshakes_per_second", "gauge",
+                                         "Handshakes completed during the last complete second.",
+                                         tlsContext->handshakesLastSecond());
+            RequestMetrics::renderSample(out, "tls_resumption_ratio", "gauge",
+                                         "Resumed over completed handshakes since startup.", tlsContext->resumptionRatio());
+            out += "# HELP tls_kernel_offload_total Connections whose record layer moved into kernel TLS, by direction.\n"
+                   "# TYPE tls_kernel_offload_total counter\n"
+                   "tls_kernel_offload_total{direction=\"send\"} " + std::to_string(tlsContext->kernelSendSessions()) + "\n"
+                   "tls_kernel_offload_total{direction=\"recv\"} " + std::to_string(tlsContext->kernelRecvSessions()) + "\n";
+        }
+        RequestMetrics::renderSample(out, "network_peers_total", "gauge", "Peers known to this node.",
+                                     peerNetwork.getPeers().size());
+        RequestMetrics::renderSample(out, "tally_ledger_transactions_total", "counter",
+                                     "Ledger transfers since startup.", tallyLedger.getVersion());
+
+        uint64_t hits = assetCache->hits(), misses = assetCache->misses();
+        RequestMetrics::renderSample(out, "static_cache_hits_total", "counter", "Static asset cache hits.", hits);
+        RequestMetrics::renderSample(out, "static_cache_misses_total", "counter", "Static asset cache misses.", misses);
+        RequestMetrics::renderSample(out, "static_cache_hit_ratio", "gauge", "Hits over lookups since startup.",
+                                     hits + misses ? (double)hits / (hits + misses) : 0.0);
+
+        RequestMetrics::renderSample(out, "log_lines_dropped_total", "counter",
+                                     "Log and access log lines dropped because the ring was full.",
+                                     logger.linesDropped() + accessLog.linesDropped());
+        RequestMetrics::renderSample(out, "process_uptime_seconds", "gauge", "Seconds since the server started.",
+                                     difftime(time(nullptr), startTime));
+
+        long pages = 0, residentPages = 0;
+        FILE* statm = fopen("/proc/self/statm", "r");
+        if (statm) {
+            if (fscanf(statm, "%ld %ld", &pages, &residentPages) != 2) residentPages = 0;
+            fclose(statm);
+        }
+        out += "# HELP process_memory_usage_bytes Process memory by type.\n"
+               "# TYPE process_memory_usage_bytes gauge\n"
+               "process_memory_usage_bytes{type=\"rss\"} " +
+               std::to_string(residentPages * sysconf(_SC_PAGESIZE)) + "\n";
+        return out;
+    }
+
+    std::string getLoggingJson() const {
+        return "{\"lines_written\":" + std::to_string(logger.linesWritten()) +
+               ",\"lines_dropped\":" + std::to_string(logger.linesDropped()) +
+               ",\"access_lines_written\":" + std::to_string(accessLog.linesWritten()) +
+               ",\"access_lines_dropped\":" + std::to_string(accessLog.linesDropped()) + "}";
     }
 
     std::string getUptime() const {
@@ -762,14 +1290,24 @@ public:
         std::stringstream ss;
         ss << "👤 User: " << currentUser << "\n"
            << "⏰ Uptime: " << getUptime() << "\n"
-           << "🔌 Active Connections: " << activeConnections << "\n"
-           << "👥 Active Sessions: " << userSessions.size() << "\n"
+           << "🔌 Active Connections: " << admission.connections() << "\n"
+           << "👥 Active Sessions: " << sessionCount() << "\n"
            << "🌐 Network: " << peerNetwork.getNodeId() << " (" << peerNetwork.getNodeIp() << ")" << "\n"
            << "🔗 Peers: " << peerNetwork.getPeers().size() << "\n"
            << "📊 " << tallyLedger.getLedgerSummary();
         return ss.str();
     }
 
+    void trackSession(const std::string& clientIP) {
+        std::lock_guard<std::mutex> lock(sessionsMutex);
+        userSessions[clientIP] = time(nullptr);
+    }
+
+    size_t sessionCount() const {
+        std::lock_guard<std::mutex> lock(sessionsMutex);
+        return userSessions.size();
+    }
+
     bool start(bool daemonMode = false) {
         if (daemonMode) {
             // Simple daemon mode - just run in background without forking complexities
@@ -785,35 +1323,67 @@ public:
         }
         #endif
 
-        serverSocket = socket(AF_INET, SOCK_STREAM, 0);
-        if (serverSocket == INVALID_SOCKET) {
-            std::cerr << "Socket creation failed: " << SOCKET_ERROR_CODE << std::endl;
-            return false;
+        if (options.tlsPort > 0) {
+            tlsContext = std::make_unique<TlsContext>();
+            std::string error;
+            if (!tlsContext->init(options.tls, error)) {
+                std::cerr << "TLS setup failed: " << error << std::endl;
+                tlsContext.reset();
+                return false;
+            }
         }
 
-        // Set socket options
-        int opt = 1;
-        #ifdef _WIN32
-        setsockopt(serverSocket, SOL_SOCKET, SO_REUSEADDR, (char*)&opt, sizeof(opt));
-        #else
-        setsockopt(serverSocket, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
-        #endif
-
-        sockaddr_in serverAddr;
-        serverAddr.sin_family = AF_INET;
-        serverAddr.sin_addr.s_addr = INADDR_ANY;
-        serverAddr.sin_port = htons(port);
-
-        if (bind(serverSocket, (sockaddr*)&serverAddr, sizeof(serverAddr)) == SOCKET_ERROR) {
-            std::cerr << "Bind failed: " << SOCKET_ERROR_CODE << std::endl;
-            CLOSE_SOCKET(serverSocket);
-            return false;
+        // With more than one listener every socket sets SO_REUSEPORT and the kernel
+        // hashes incoming connections across them. The TLS port gets as many listeners.
+        int listenerCount = std::max(1, options.listeners);
+        for (int listenPort : {port, options.tlsPort}) {
+            if (listenPort <= 0) continue;
+            for (int i = 0; i < listenerCount; i++) {
+                int fd = Listener::open(listenPort, options.backlog, listenerCount > 1);
+                if (fd < 0) {
+                    for (int open : listenSockets) CLOSE_SOCKET(open);
+                    listenSockets.clear();
+                    return false;
+                }
+                listenSockets.push_back(fd);
+            }
+        }
+        plainListeners = listenerCount;
+        serverSocket = listenSockets[0];
+
+        if (options.ioModel == "uring" && !IoUring::supported()) {
+            std::cerr << "⚠️  io_uring is unavailable on this kernel, falling back to epoll" << std::endl;
+            options.ioModel = "epoll";
+        }
+        // Ring connections never see their bytes outside the kernel, so TLS needs a reactor
+        if (options.ioModel == "uring" && tlsContext) {
+            std::cerr << "⚠️  TLS is served by the threads and epoll models, falling back to epoll" << std::endl;
+            options.ioModel = "epoll";
+        }
+        if (options.ioModel == "uring") backend = std::make_unique<UringBackend>(this);
+        else if (options.ioModel == "epoll") backend = std::make_unique<EpollBackend>(this);
+        else backend = std::make_unique<ThreadsBackend>(this);
+
+        int acceptorCount = options.ioModel == "threads" ? listenerCount : eventLoopCount();
+        for (int i = 0; i < acceptorCount; i++) {
+            auto acceptor = std::make_unique<Acceptor>();
+            acceptor->listener = i % listenerCount;
+            acceptors.push_back(std::move(acceptor));
+        }
+        // Event loops drain the TLS listeners alongside their own; the threads model gives
+        // each one an accept thread
+        if (tlsContext && options.ioModel == "threads") {
+            for (int i = 0; i < listenerCount; i++) {
+                auto acceptor = std::make_unique<Acceptor>();
+                acceptor->listener = listenerCount + i;
+                acceptor->tls = true;
+                acceptors.push_back(std::move(acceptor));
+            }
         }
 
-        if (listen(serverSocket, 10) == SOCKET_ERROR) {
-            std::cerr << "Listen failed: " << SOCKET_ERROR_CODE << std::endl;
-            CLOSE_SOCKET(serverSocket);
-            return false;
+        if (options.staticCacheMB > 0) {
+            assetCache->startWatcher();
+            if (options.warmCache) assetCache->warm();
         }
 
         // Start peer network (Tailscale replacement)
@@ -828,6 +1398,16 @@ public:
             std::cout << "📁 Serving from: " << fs::absolute(rootDir) << std::endl;
             std::cout << "🌐 Access: http://localhost:" << port << std::endl;
             std::cout << "👤 Running as: " << currentUser << std::endl;
+            std::cout << "⚙️  I/O model: " << backend->name();
+            if (options.ioModel != "threads") std::cout << " (" << eventLoopCount() << " loops)";
+            else std::cout << " (" << workerThreadCount() << " workers)";
+            std::cout << std::endl;
+            std::cout << "👂 Listeners: " << listenSockets.size() << (listenSockets.size() > 1 ? " (SO_REUSEPORT)" : "")
+                      << ", backlog " << options.backlog << (options.pinCpus ? ", pinned to cores" : "") << std::endl;
+            if (tlsContext) {
+                std::cout << "🔒 HTTPS: https://localhost:" << options.tlsPort
+                          << (options.tls.kernelOffload ? " (kTLS where the kernel supports it)" : "") << std::endl;
+            }
             std::cout << "🔗 Network: " << peerNetwork.getNodeId() << " (" << peerNetwork.getNodeIp() << ")" << std::endl;
             std::cout << tallyLedger.getLedgerSummary() << std::endl;
             std::cout << "⏹️  Press Ctrl+C to stop" << std::endl;
@@ -853,12 +1433,90 @@ public:
             exit(0);
         });
 
+        // Peers that hang up mid-sendfile must not kill the server
+        signal(SIGPIPE, SIG_IGN);
+
         signal(SIGHUP, [](int sig) {
             // Could implement config reload here
         });
     }
 
+    // Every listener needs at least one loop to drain it
+    int eventLoopCount() const {
+        int count = options.eventLoops;
+        if (count <= 0) {
+            unsigned cores = std::thread::hardware_concurrency();
+            count = cores > 0 ? (int)cores : 1;
+        }
+        return std::max(count, options.listeners);
+    }
+
+    int workerThreadCount() const {
+        return options.workerThreads > 0 ? options.workerThreads : (int)WorkStealingPool::defaultThreadCount();
+    }
+
+    std::string getAdmissionJson() const {
+        const AdmissionControl::Limits& limits = admission.getLimits();
+        return "{\"max_connections\":" + std::to_string(limits.maxConnections) +
+               ",\"max_queued\":" + std::to_string(limits.maxQueued) +
+               ",\"shed_percent\":" + std::to_string(limits.shedPercent) +
+               ",\"rejected_connections\":" + std::to_string(admission.rejectedConnections()) +
+               ",\"shed_requests\":" + std::to_string(admission.shedRequests()) + "}";
+    }
+
+    std::string getTimeoutsJson() const {
+        std::string json = "{";
+        for (int phase = 0; phase < 4; phase++) {
+            json += std::string(phase ? "," : "") + "\"" + PHASE_NAMES[phase] + "\":" +
+                    std::to_string(connectionTimeouts[phase].load(std::memory_order_relaxed));
+        }
+        return json + "}";
+    }
+
+    // Worker pool counters as a JSON fragment (without braces)
+    std::string getPoolStatsJson() const {
+        if (!workerPool) {
+            return "\"workers\":0,\"queue_depth\":0,\"steals\":0,\"tasks_executed\":0";
+        }
+        std::string depths;
+        for (size_t depth : workerPool->queueDepths()) {
+            if (!depths.empty()) depths += ",";
+            depths += std::to_string(depth);
+        }
+        return "\"workers\":" + std::to_string(workerPool->size()) +
+               ",\"queue_depth\":" + std::to_string(workerPool->queueDepth()) +
+               ",\"worker_queue_depths\":[" + depths + "]" +
+               ",\"steals\":" + std::to_string(workerPool->stealCount()) +
+               ",\"tasks_executed\":" + std::to_string(workerPool->executedCount());
+    }
+
+    std::string getStaticCacheJson() const {
+        return assetCache->toJson();
+    }
+
+    // Per-acceptor accept counters as a JSON fragment (without braces)
+    std::string getListenerStatsJson() const {
+        double uptime = difftime(time(nullptr), startTime);
+        std::string entries;
+        for (const auto& acceptor : acceptors) {
+            if (!entries.empty()) entries += ",";
+            entries += acceptor->stats.toJson(acceptor->listener, uptime);
+        }
+        return "\"listen_backlog\":" + std::to_string(options.backlog) +
+               ",\"reuseport\":" + std::string(options.listeners > 1 ? "true" : "false") +
+               ",\"listeners\":[" + entries + "]";
+    }
+
     void run() {
+        backend->run();
+    }
+
+    // Blocking accept loop for one listener in the threads model
+    void acceptLoop(size_t index) {
+        Acceptor& acceptor = *acceptors[index];
+        int listenSocket = listenSockets[acceptor.listener];
+        if (options.pinCpus) Listener::pinCurrentThread((int)index);
+
         while (running) {
             sockaddr_in clientAddr;
             #ifdef _WIN32
@@ -868,9 +1526,9 @@ public:
             #endif
 
             #ifdef _WIN32
-            SOCKET clientSocket = accept(serverSocket, (sockaddr*)&clientAddr, &clientAddrLen);
+            SOCKET clientSocket = accept(listenSocket, (sockaddr*)&clientAddr, &clientAddrLen);
             #else
-            int clientSocket = accept(serverSocket, (sockaddr*)&clientAddr, &clientAddrLen);
+            int clientSocket = accept(listenSocket, (sockaddr*)&clientAddr, &clientAddrLen);
             #endif
 
             if (clientSocket == INVALID_SOCKET) {
@@ -879,12 +1537,23 @@ public:
                 }
                 continue;
             }
+            acceptor.stats.record();
 
-            // Handle client in a separate thread
-            std::thread([this, clientSocket]() {
-                handleClient(clientSocket);
+            // Refuse outright rather than queue behind more work than the limits allow
+            if (!admission.tryAdmitConnection(workerPool->queueDepth())) {
+                admission.rejectConnection(clientSocket);
                 CLOSE_SOCKET(clientSocket);
-            }).detach();
+                continue;
+            }
+
+            // Hand the client to the bounded worker pool. Its socket is non-blocking: whenever
+            // it has to wait for input it goes to the connection waiter instead.
+            EventLoop::setNonBlocking(clientSocket);
+            std::string clientIP = inet_ntoa(clientAddr.sin_addr);
+            trackSession(clientIP);
+            auto connection = std::make_shared<PooledConnection>(this, clientSocket, clientIP,
+                                                                 acceptor.tls ? tlsContext.get() : nullptr);
+            workerPool->submit([this, connection]() { serveConnection(connection); });
         }
     }
 
@@ -894,13 +1563,18 @@ public:
         running = false;
         logMessage("Server shutting down");
 
+        if (backend) backend->stop();
+
         // Stop peer network
         peerNetwork.stopNetwork();
+        assetCache->stopWatcher();
 
-        if (serverSocket != INVALID_SOCKET) {
-            CLOSE_SOCKET(serverSocket);
-            serverSocket = INVALID_SOCKET;
+        for (int fd : listenSockets) {
+            shutdown(fd, SHUT_RDWR); // wakes a thread blocked in accept()
+            CLOSE_SOCKET(fd);
         }
+        listenSockets.clear();
+        serverSocket = INVALID_SOCKET;
 
         // Cleanup PID file
         removePidFile();
@@ -913,232 +1587,607 @@ public:
     }
 
 private:
-    void handleClient(int clientSocket) {
-        activeConnections++;
+    // One pool task on a threads-model connection: advance the TLS handshake, answer every
+    // request that has arrived and read until the socket runs dry. A worker never waits
+    // for input; a connection that needs more is parked on the connection waiter, which
+    // submits it again once readable. Returning without parking closes the connection.
+    void serveConnection(const std::shared_ptr<PooledConnection>& connection) {
+        PooledConnection& c = *connection;
+        if (c.tls && !c.tls->isEstablished()) {
+            TlsSession::Status status = c.tls->handshake();
+            if (status == TlsSession::Status::Error) return;
+            if (status != TlsSession::Status::Done) {
+                parkConnection(connection, status == TlsSession::Status::WantWrite ? EPOLLOUT : EPOLLIN);
+                return;
+            }
+        }
 
-        char buffer[4096];
-        int bytesReceived = recv(clientSocket, buffer, sizeof(buffer) - 1, 0);
+        char chunk[8192];
+        while (true) {
+            // Answer every complete pipelined request in order, batched into one write
+            while (!c.closeAfterFlush) {
+                TraceSpan parseSpan("parse");
+                HttpParser::Status status = c.parser.parse(c.input);
+                parseSpan.end();
+                if (status == HttpParser::Status::Incomplete) break;
+
+                HttpResponse response(c.output, c.arena);
+                if (status == HttpParser::Status::Error) {
+                    rejectRequest(response, c.parser.errorCode());
+                } else {
+                    response.keepAlive = ++c.served < options.keepAliveRequests && keepAliveEnabled();
+                    serveRequest(c.parser.request(), response, c.clientIP);
+                    c.input.erase(0, c.parser.consumed());
+                    c.parser.reset();
+                }
+                c.arena.reset();
+                if (!response.keepAlive) c.closeAfterFlush = true;
+            }
 
-        // Track user session based on IP
-        sockaddr_in clientAddr;
-        socklen_t clientAddrLen = sizeof(clientAddr);
-        getpeername(clientSocket, (sockaddr*)&clientAddr, &clientAddrLen);
-        std::string clientIP = inet_ntoa(clientAddr.sin_addr);
-        userSessions[clientIP] = time(nullptr);
+            if (!c.output.empty()) {
+                TraceSpan sendSpan("send");
+                if (!flushConnection(c)) return;
+            }
+            if (c.closeAfterFlush) return;
+
+            TraceSpan recvSpan("recv");
+            ssize_t received = c.tls ? c.tls->read(chunk, sizeof(chunk)) : recv(c.fd, chunk, sizeof(chunk), 0);
+            recvSpan.end();
+            if (received > 0) {
+                // The next head's deadline runs from its first byte
+                if (c.input.empty() && c.served > 0 && !c.parser.readingBody()) {
+                    c.headerDeadline = std::chrono::steady_clock::now() + phaseTimeout(ConnectionPhase::Header);
+                }
+                c.input.append(chunk, received);
+                continue;
+            }
+            if (received < 0 && errno == EINTR) continue;
+            if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) parkConnection(connection, EPOLLIN);
+            return; // closed or failed
+        }
+    }
+
+    // Park `connection` on the waiter until `events`, under the deadline of the phase it is
+    // in. A head deadline is fixed; body and idle waits start afresh on every park.
+    void parkConnection(const std::shared_ptr<PooledConnection>& connection, uint32_t events) {
+        PooledConnection& c = *connection;
+        c.phase = c.parser.readingBody() ? ConnectionPhase::Body
+                  : !c.input.empty() || c.served == 0 || !keepAliveEnabled() ? ConnectionPhase::Header
+                  : ConnectionPhase::Idle;
+        c.wait = phaseTimeout(c.phase);
+        if (c.phase == ConnectionPhase::Header) {
+            c.wait = std::chrono::duration_cast<std::chrono::milliseconds>(c.headerDeadline - std::chrono::steady_clock::now());
+            if (c.wait.count() <= 0) {
+                countTimeout(c.phase);
+                return;
+            }
+        }
+        c.waitEvents = events;
+        connectionWaiter->park(connection);
+    }
 
-        if (bytesReceived <= 0) {
-            return;
+    // Write the queued responses, waiting for the socket whenever it is full. A client that
+    // takes nothing for the write timeout is dropped.
+    bool flushConnection(PooledConnection& c) {
+        while (true) {
+            SendQueue::Result result = c.tls ? c.tls->write(c.output) : c.output.writeTo(c.fd);
+            if (result == SendQueue::Result::Done) return true;
+            if (result == SendQueue::Result::Error) return false;
+            pollfd writable{c.fd, POLLOUT, 0};
+            int ready = poll(&writable, 1, options.writeTimeout * 1000);
+            if (ready == 0) countTimeout(ConnectionPhase::Write);
+            if (ready <= 0) return false;
         }
+    }
 
-        buffer[bytesReceived] = '\0';
-        std::string request(buffer);
+    void countTimeout(ConnectionPhase phase) {
+        connectionTimeouts[(int)phase].fetch_add(1, std::memory_order_relaxed);
+    }
 
-        // Parse HTTP request
-        std::string method, path, httpVersion;
-        std::istringstream requestStream(request);
-        requestStream >> method >> path >> httpVersion;
+    bool keepAliveEnabled() const {
+        return options.keepAliveTimeout > 0 && running;
+    }
 
-        // Handle API endpoints
-        if (path == "/api/tally/combine") {
-            if (tallyLedger.combineTallies()) {
-                sendResponse(clientSocket, "200 OK", "application/json",
-                    "{\"status\":\"success\",\"message\":\"Tallies combined - collective sovereignty activated\"}");
-            } else {
-                sendResponse(clientSocket, "400 Bad Request", "application/json",
-                    "{\"status\":\"error\",\"message\":\"Cannot combine tallies\"}");
-            }
-            return;
-        }
-        else if (path == "/api/tally/separate") {
-            if (tallyLedger.separateTallies()) {
-                sendResponse(clientSocket, "200 OK", "application/json",
-                    "{\"status\":\"success\",\"message\":\"Tallies separated - individual sovereignty restored\"}");
-            } else {
-                sendResponse(clientSocket, "400 Bad Request", "application/json",
-                    "{\"status\":\"error\",\"message\":\"Cannot separate tallies\"}");
-            }
-            return;
-        }
-        else if (path == "/api/tally/status") {
-            sendResponse(clientSocket, "200 OK", "application/json",
-                "{\"user\":" + std::to_string(tallyLedger.getBalance("user")) +
-                ",\"network\":" + std::to_string(tallyLedger.getBalance("network")) +
-                ",\"collective\":" + std::to_string(tallyLedger.getBalance("collective")) + "}");
-            return;
+    // handleRequest plus its metrics and access log line, timed from a complete parse to
+    // the response being queued
+    void serveRequest(const HttpRequest& request, HttpResponse& response, std::string_view clientIP) {
+        TraceSpan span("request");
+        auto start = std::chrono::steady_clock::now();
+        size_t queuedBefore = response.output.pendingBytes();
+        handleRequest(request, response);
+        auto micros = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+        size_t bytes = response.output.pendingBytes() - queuedBefore;
+
+        size_t route = response.route >= 0 ? (size_t)response.route : requestMetrics->routeCount() - 1;
+        requestMetrics->record(route, response.status, micros.count(), bytes);
+        if (accessLog.isOpen()) {
+            accessLog.access(clientIP, request.method, request.target, request.version, response.status,
+                             bytes, micros.count());
         }
-        else if (path == "/api/server/stats") {
-            sendResponse(clientSocket, "200 OK", "application/json",
-                "{\"user\":\"" + currentUser + "\"" +
-                ",\"uptime\":\"" + getUptime() + "\"" +
-                ",\"active_connections\":" + std::to_string(activeConnections) +
-                ",\"active_sessions\":" + std::to_string(userSessions.size()) + "}");
-            return;
+    }
+
+    // Answer a request the parser refused (400, 413, 431, 501, 505). It never reaches the router, so
+    // it is counted under the static route with no handling time.
+    void rejectRequest(HttpResponse& response, int code) {
+        size_t queuedBefore = response.output.pendingBytes();
+        sendError(response, code, HttpParser::errorReason(code));
+        requestMetrics->record(requestMetrics->routeCount() - 1, code, 0, response.output.pendingBytes() - queuedBefore);
+    }
+
+    // Route one complete request and append the HTTP response to `response`. The caller
+    // sets response.keepAlive when the connection may persist; the client can veto it.
+    void handleRequest(const HttpRequest& request, HttpResponse& response) {
+        AllocStats::Scope allocations;
+        response.keepAlive = response.keepAlive && request.keepAlive;
+        if (options.compressionLevel > 0) {
+            response.acceptEncoding = Compression::negotiate(request.header("Accept-Encoding"));
         }
-        else if (path == "/api/server/info") {
-            std::string stats = getServerStats();
-            sendResponse(clientSocket, "200 OK", "text/plain", stats);
+
+        std::string_view method = request.method;
+        std::string_view path = request.path;
+
+        // Under load the ledger API keeps being served while static files and other endpoints shed
+        bool priority = path.substr(0, 11) == "/api/tally/";
+        if (!admission.admitRequest(priority, workerPool ? workerPool->queueDepth() : 0)) {
+            response.keepAlive = false;
+            sendError(response, 503, "Service Unavailable", admission.retryAfterHeader());
             return;
         }
-        else if (path == "/api/network/peers") {
-            auto peers = peerNetwork.getPeers();
-            std::string json = "[\n";
-            for (size_t i = 0; i < peers.size(); ++i) {
-                json += "  {\"id\":\"" + peers[i].getId() + "\",\"ip\":\"" + peers[i].getIp() + "\",\"authenticated\":" +
-                       (peers[i].isAuthenticated() ? "true" : "false") + "}";
-                if (i < peers.size() - 1) json += ",\n";
+
+        // API endpoints resolve through the compile-time route table in one hash probe
+        RouteMatch route = TALLY_ROUTES.match(method, path);
+        if (route.found()) {
+            response.route = route.id;
+            if (!route.methodAllowed) {
+                sendError(response, 405, "Method Not Allowed",
+                          "Allow: " + TALLY_ROUTES.allowHeader(route.allowedMethods) + "\r\n");
+                return;
+            }
+            switch ((TallyRoute)route.id) {
+                case TallyRoute::TallyCombine: {
+                    if (tallyLedger.combineTallies()) {
+                        sendResponse(response, "200 OK", "application/json",
+                            "{\"status\":\"success\",\"message\":\"Tallies combined - collective sovereignty activated\"}");
+                    } else {
+                        sendResponse(response, "400 Bad Request", "application/json",
+                            "{\"status\":\"error\",\"message\":\"Cannot combine tallies\"}");
+                    }
+                    return;
+                }
+                case TallyRoute::TallySeparate: {
+                    if (tallyLedger.separateTallies()) {
+                        sendResponse(response, "200 OK", "application/json",
+                            "{\"status\":\"success\",\"message\":\"Tallies separated - individual sovereignty restored\"}");
+                    } else {
+                        sendResponse(response, "400 Bad Request", "application/json",
+                            "{\"status\":\"error\",\"message\":\"Cannot separate tallies\"}");
+                    }
+                    return;
+                }
+                case TallyRoute::TallyStatus: {
+                    // Read the version first: a transfer racing this request can only make the tag older
+                    ArenaString etag = response.arena.string("W/\"tally-");
+                    appendNumber(etag, tallyLedger.getVersion()).append("\"");
+                    ArenaString validators = response.arena.string("ETag: ");
+                    validators.append(etag).append("\r\n");
+                    if (ConditionalRequest::notModified(request, etag)) {
+                        sendNotModified(response, validators);
+                        return;
+                    }
+                    ArenaString json = response.arena.string("{\"user\":");
+                    appendNumber(json, tallyLedger.getBalance("user")).append(",\"network\":");
+                    appendNumber(json, tallyLedger.getBalance("network")).append(",\"collective\":");
+                    appendNumber(json, tallyLedger.getBalance("collective")).append("}");
+                    sendResponse(response, "200 OK", "application/json", json, validators);
+                    return;
+                }
+                case TallyRoute::ServerStats: {
+                    sendResponse(response, "200 OK", "application/json",
+                        "{\"user\":\"" + currentUser + "\"" +
+                        ",\"uptime\":\"" + getUptime() + "\"" +
+                        ",\"io_model\":\"" + std::string(backend->name()) + "\"" +
+                        ",\"active_connections\":" + std::to_string(admission.connections()) +
+                        ",\"admission\":" + getAdmissionJson() +
+                        ",\"timeouts\":" + getTimeoutsJson() +
+                        ",\"active_sessions\":" + std::to_string(sessionCount()) +
+                        "," + getPoolStatsJson() +
+                        "," + getListenerStatsJson() +
+                        ",\"tls\":" + (tlsContext ? tlsContext->toJson() : std::string("null")) +
+                        ",\"static_cache\":" + getStaticCacheJson() +
+                        ",\"allocations\":" + AllocStats::toJson() +
+                        ",\"logging\":" + getLoggingJson() + "}");
+                    return;
+                }
+                case TallyRoute::ServerInfo: {
+                    std::string stats = getServerStats();
+                    sendResponse(response, "200 OK", "text/plain", stats);
+                    return;
+                }
+                case TallyRoute::NetworkPeers: {
+                    auto peers = peerNetwork.getPeers();
+                    ArenaString json = response.arena.string("[\n");
+                    for (size_t i = 0; i < peers.size(); ++i) {
+                        json.append("  {\"id\":\"").append(peers[i].getId()).append("\",\"ip\":\"").append(peers[i].getIp())
+                            .append("\",\"authenticated\":").append(peers[i].isAuthenticated() ? "true" : "false").append("}");
+                        if (i < peers.size() - 1) json += ",\n";
+                    }
+                    json += "\n]";
+                    sendResponse(response, "200 OK", "application/json", json);
+                    return;
+                }
+                case TallyRoute::NetworkAddPeer: {
+                    // Simple peer addition for demo - in real implementation would use proper authentication
+                    std::string peer_ip = "10.0.0.2"; // Default peer IP
+                    std::string peer_id = "peer_" + std::to_string(time(nullptr));
+                    peerNetwork.addPeer(peer_id, peer_ip);
+                    sendResponse(response, "200 OK", "application/json",
+                        "{\"status\":\"success\",\"message\":\"Peer added\",\"peer_id\":\"" + peer_id + "\",\"peer_ip\":\"" + peer_ip + "\"}");
+                    return;
+                }
+                case TallyRoute::NetworkInfo: {
+                    ArenaString info = response.arena.string("🌐 Tally Network Information\n");
+                    info.append("Node ID: ").append(peerNetwork.getNodeId()).append("\n");
+                    info.append("Node IP: ").append(peerNetwork.getNodeIp()).append("\n");
+                    appendNumber(info.append("Peers: "), peerNetwork.getPeers().size()).append("\n");
+                    sendResponse(response, "200 OK", "text/plain", info);
+                    return;
+                }
+                case TallyRoute::NetworkPublicKey: {
+                    sendResponse(response, "200 OK", "text/plain", peerNetwork.getPublicKey());
+                    return;
+                }
+                case TallyRoute::NetworkDiscover: {
+                    peerNetwork.broadcastDiscovery();
+                    sendResponse(response, "200 OK", "application/json",
+                        "{\"status\":\"success\",\"message\":\"Network discovery initiated\"}");
+                    return;
+                }
+                case TallyRoute::NetworkChallenge: {
+                    // Generate authentication challenge
+                    std::string peer_id = "demo_peer"; // In real implementation, get from request
+                    std::string challenge = peerNetwork.generateAuthChallenge(peer_id);
+                    sendResponse(response, "200 OK", "text/plain", challenge);
+                    return;
+                }
+                case TallyRoute::NetworkSend: {
+                    // Send secure message to the peer named by the {peer} segment
+                    std::string peer_id(route.param);
+                    std::string message = "Secure message from server"; // In real implementation, get from request body
+                    std::string encrypted = peerNetwork.sendSecureMessage(peer_id, message);
+                    if (!encrypted.empty()) {
+                        sendResponse(response, "200 OK", "application/octet-stream", encrypted);
+                    } else {
+                        sendResponse(response, "404 Not Found", "application/json",
+                            "{\"status\":\"error\",\"message\":\"Peer not found\"}");
+                    }
+                    return;
+                }
+                case TallyRoute::NetworkScan: {
+                    peerNetwork.scanNetwork();
+                    sendResponse(response, "200 OK", "application/json",
+                        "{\"status\":\"success\",\"message\":\"Network scan completed\"}");
+                    return;
+                }
+                case TallyRoute::NetworkOptimize: {
+                    peerNetwork.optimizeTopology();
+                    sendResponse(response, "200 OK", "application/json",
+                        "{\"status\":\"success\",\"message\":\"Network topology optimized\"}");
+                    return;
+                }
+                case TallyRoute::NetworkStatus: {
+                    std::string status = peerNetwork.getNetworkStatus();
+                    sendResponse(response, "200 OK", "text/plain", status);
+                    return;
+                }
+                case TallyRoute::ServerTrace: {
+                    // POST ?enable=0|1 switches recording; GET ?seconds=N dumps the last N seconds
+                    Tracer& tracer = Tracer::instance();
+                    if (method == "POST") {
+                        tracer.enable(queryParam(request.query, "enable") != "0");
+                        logMessage(tracer.enabled() ? "Tracing enabled" : "Tracing disabled");
+                        sendResponse(response, "200 OK", "application/json",
+                                     tracer.enabled() ? "{\"tracing\":true}" : "{\"tracing\":false}");
+                        return;
+                    }
+                    double seconds = 5;
+                    std::string_view requested = queryParam(request.query, "seconds");
+                    if (!requested.empty()) seconds = std::max(0.0, atof(std::string(requested).c_str()));
+                    sendResponse(response, "200 OK", "application/json", tracer.toChromeJson(seconds));
+                    return;
+                }
+                case TallyRoute::Metrics: {
+                    sendResponse(response, "200 OK", "text/plain; version=0.0.4", getMetricsText());
+                    return;
+                }
             }
-            json += "\n]";
-            sendResponse(clientSocket, "200 OK", "application/json", json);
-            return;
         }
-        else if (path == "/api/network/add-peer") {
-            // Simple peer addition for demo - in real implementation would use proper authentication
-            std::string peer_ip = "10.0.0.2"; // Default peer IP
-            std::string peer_id = "peer_" + std::to_string(time(nullptr));
-            peerNetwork.addPeer(peer_id, peer_ip);
-            sendResponse(clientSocket, "200 OK", "application/json",
-                "{\"status\":\"success\",\"message\":\"Peer added\",\"peer_id\":\"" + peer_id + "\",\"peer_ip\":\"" + peer_ip + "\"}");
-            return;
+
+        // Default to index.html if root path
+        if (path == "/") {
+            path = "/index.html";
         }
-        else if (path == "/api/network/info") {
-            std::string info = "🌐 Tally Network Information\n";
-            info += "Node ID: " + peerNetwork.getNodeId() + "\n";
-            info += "Node IP: " + peerNetwork.getNodeIp() + "\n";
-            info += "Peers: " + std::to_string(peerNetwork.getPeers().size()) + "\n";
-            sendResponse(clientSocket, "200 OK", "text/plain", info);
+
+        // Security: Prevent directory traversal
+        if (path.find("..") != std::string_view::npos) {
+            sendError(response, 403, "Forbidden");
             return;
         }
-        else if (path == "/api/network/public-key") {
-            sendResponse(clientSocket, "200 OK", "text/plain", peerNetwork.getPublicKey());
-            return;
+
+        // Serve file with tally fingerprinting
+        if (method == "GET") {
+            serveFile(request, response, path);
+        } else {
+            sendError(response, 405, "Method Not Allowed");
         }
-        else if (path == "/api/network/discover") {
-            peerNetwork.broadcastDiscovery();
-            sendResponse(clientSocket, "200 OK", "application/json",
-                "{\"status\":\"success\",\"message\":\"Network discovery initiated\"}");
+    }
+
+    void serveFile(const HttpRequest& request, HttpResponse& response, std::string_view path) {
+        TraceSpan span("serveFile");
+        ArenaString fullPath = response.arena.string(rootDir);
+        fullPath += path;
+        TraceSpan lookupSpan("cache.lookup");
+        std::shared_ptr<const CachedAsset> asset = assetCache->lookup(fullPath);
+        lookupSpan.end();
+        if (!asset) {
+            sendError(response, 404, "Not Found");
             return;
         }
-        else if (path == "/api/network/challenge") {
-            // Generate authentication challenge
-            std::string peer_id = "demo_peer"; // In real implementation, get from request
-            std::string challenge = peerNetwork.generateAuthChallenge(peer_id);
-            sendResponse(clientSocket, "200 OK", "text/plain", challenge);
+        if (asset->size == 0) {
+            sendError(response, 500, "Internal Server Error");
             return;
         }
-        else if (path.find("/api/network/send/") == 0) {
-            // Send secure message to peer
-            size_t pos = path.find_last_of('/');
-            std::string peer_id = path.substr(pos + 1);
-            std::string message = "Secure message from server"; // In real implementation, get from request body
-            std::string encrypted = peerNetwork.sendSecureMessage(peer_id, message);
-            if (!encrypted.empty()) {
-                sendResponse(clientSocket, "200 OK", "application/octet-stream", encrypted);
-            } else {
-                sendResponse(clientSocket, "404 Not Found", "application/json",
-                    "{\"status\":\"error\",\"message\":\"Peer not found\"}");
+
+        // Apply tally fingerprint to HTML content
+        if (asset->isHtml()) {
+            if (options.fingerprintMode != "request") {
+                serveFingerprintedPage(request, response, *asset, path);
+                return;
             }
+            // A new fingerprint on every response: no validators, so never a 304
+            std::string content = asset->identity.bytes ? *asset->identity.bytes : readFile(asset->fullPath);
+            if (content.empty()) {
+                sendError(response, 500, "Internal Server Error");
+                return;
+            }
+            std::string page = fingerprintContent(content, std::string(path),
+                                                  [this](const std::string& data) { return tallyLedger.generateHash(data); });
+            sendResponse(response, "200 OK", asset->contentType, page);
             return;
         }
-        else if (path == "/api/network/scan") {
-            peerNetwork.scanNetwork();
-            sendResponse(clientSocket, "200 OK", "application/json",
-                "{\"status\":\"success\",\"message\":\"Network scan completed\"}");
+
+        // Cached bytes are shared with the send queue; larger files go out with sendfile.
+        // Ranges always address the identity body, so a Range request skips the variants.
+        bool ranged = !request.header("Range").empty();
+        const AssetBody& body = ranged ? asset->identity : asset->bodyFor(response.acceptEncoding);
+        if (ConditionalRequest::notModified(request, body.etag, asset->mtime.tv_sec)) {
+            sendNotModified(response, body.validators);
             return;
         }
-        else if (path == "/api/network/optimize") {
-            peerNetwork.optimizeTopology();
-            sendResponse(clientSocket, "200 OK", "application/json",
-                "{\"status\":\"success\",\"message\":\"Network topology optimized\"}");
+        std::vector<ByteRange::Span> ranges;
+        ByteRange::Outcome outcome = ranged
+            ? ByteRange::evaluate(request, asset->size, body.etag, asset->mtime.tv_sec, ranges)
+            : ByteRange::Outcome::Full;
+        if (outcome == ByteRange::Outcome::Unsatisfiable) {
+            sendError(response, 416, "Range Not Satisfiable",
+                      "Content-Range: " + ByteRange::unsatisfiedRange(asset->size) + "\r\n");
             return;
         }
-        else if (path == "/api/network/status") {
-            std::string status = peerNetwork.getNetworkStatus();
-            sendResponse(clientSocket, "200 OK", "text/plain", status);
+        int fd = -1;
+        if (!body.bytes) {
+            fd = open(asset->fullPath.c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd < 0) {
+                sendError(response, 500, "Internal Server Error");
+                return;
+            }
+        }
+        if (outcome == ByteRange::Outcome::Partial) {
+            sendRanges(response, *asset, std::move(ranges), fd);
             return;
         }
-
-        // Default to index.html if root path
-        if (path == "/") {
-            path = "/index.html";
+        response.head().status("200 OK").headers(body.headers).headers(body.validators)
+            .headers(connectionHeaders(response)).end();
+        if (body.bytes) {
+            response.output.append(body.bytes);
+        } else {
+            response.output.appendFile(fd, 0, asset->size);
         }
+    }
 
-        // Remove query parameters
-        size_t queryPos = path.find('?');
-        if (queryPos != std::string::npos) {
-            path = path.substr(0, queryPos);
-        }
+    // Page for the asset's current version and window, hashing only when either changes
+    std::shared_ptr<const FingerprintedPage> fingerprintedPage(const CachedAsset& asset, std::string_view path) {
+        long long window = 0;
+        if (options.fingerprintMode == "window") window = time(nullptr) / std::max(1, options.fingerprintWindow);
 
-        // Security: Prevent directory traversal
-        if (path.find("..") != std::string::npos) {
-            sendError(clientSocket, 403, "Forbidden");
-            return;
+        std::shared_ptr<const FingerprintedPage> previous;
+        {
+            std::lock_guard<std::mutex> lock(fingerprintMutex);
+            auto it = fingerprintPages.find(asset.fullPath);
+            if (it != fingerprintPages.end()) {
+                if (it->second->etag == asset.identity.etag && it->second->window == window) return it->second;
+                previous = it->second;
+            }
         }
 
-        // Serve file with tally fingerprinting
-        if (method == "GET") {
-            serveFile(clientSocket, path);
+        TraceSpan span("fingerprint.page");
+        auto page = std::make_shared<FingerprintedPage>();
+        page->etag = asset.identity.etag;
+        page->window = window;
+        if (previous && previous->etag == asset.identity.etag) {
+            // Same file in a new window: only the short window hash is recomputed
+            page->content = previous->content;
+            page->splice = previous->splice;
+            page->versionHash = previous->versionHash;
         } else {
-            sendError(clientSocket, 405, "Method Not Allowed");
+            page->content = asset.identity.bytes ? asset.identity.bytes
+                                                 : std::make_shared<const std::string>(readFile(asset.fullPath));
+            page->splice = fingerprintSplice(*page->content);
+            page->versionHash = tallyLedger.generateHash(std::string(*page->content).append(path));
+        }
+
+        // A window's page must not revalidate in the next window, so its ETag names the
+        // window and it carries no Last-Modified
+        if (options.fingerprintMode == "window") {
+            std::string_view fileTag = asset.identity.etag;
+            if (fileTag.substr(0, 2) == "W/") fileTag.remove_prefix(2);
+            if (fileTag.size() >= 2 && fileTag.front() == '"') fileTag = fileTag.substr(1, fileTag.size() - 2);
+            page->validator = "W/\"" + std::string(fileTag) + "-w" + std::to_string(window) + "\"";
+            page->validators = "ETag: " + page->validator + "\r\n";
+        } else {
+            page->validator = asset.identity.etag;
+            page->validators = asset.identity.validators;
         }
 
-        // Cleanup connection tracking
-        activeConnections--;
-    }
+        if (page->splice != std::string::npos) {
+            std::string fingerprint = page->versionHash;
+            if (options.fingerprintMode == "window") {
+                fingerprint = tallyLedger.generateHash(page->versionHash + std::to_string(window));
+            }
+            page->comment = fingerprintComment(fingerprint);
+        }
+
+        size_t length = page->content->size() + page->comment.size();
+        if (options.compressionLevel > 0 && length >= options.compressMinBytes) {
+            std::string full = page->splice == std::string::npos
+                ? *page->content
+                : page->content->substr(0, page->splice) + page->comment + page->content->substr(page->splice);
+            auto gzip = std::make_shared<std::string>();
+            if (Compression::compress(full, ContentCoding::Gzip, options.compressionLevel, *gzip) &&
+                gzip->size() < length) {
+                page->gzip = std::move(gzip);
+            }
+            auto deflate = std::make_shared<std::string>();
+            if (Compression::compress(full, ContentCoding::Deflate, options.compressionLevel, *deflate) &&
+                deflate->size() < length) {
+                page->deflate = std::move(deflate);
+            }
+        }
 
-    void serveFile(int clientSocket, const std::string& path) {
-        std::string fullPath = rootDir + path;
+        std::lock_guard<std::mutex> lock(fingerprintMutex);
+        fingerprintPages[asset.fullPath] = page;
+        return page;
+    }
 
-        if (!fs::exists(fullPath)) {
-            sendError(clientSocket, 404, "Not Found");
+    // Send prefix, fingerprint comment and suffix as three slices of one gather write
+    void serveFingerprintedPage(const HttpRequest& request, HttpResponse& response, const CachedAsset& asset,
+                                std::string_view path) {
+        std::shared_ptr<const FingerprintedPage> page = fingerprintedPage(asset, path);
+        std::string_view vary = options.compressionLevel > 0 ? "Vary: Accept-Encoding\r\n" : "";
+        time_t lastModified = options.fingerprintMode == "window" ? 0 : asset.mtime.tv_sec;
+        if (ConditionalRequest::notModified(request, page->validator, lastModified)) {
+            sendNotModified(response, page->validators, vary);
+            return;
+        }
+        if (page->content->empty()) {
+            sendError(response, 500, "Internal Server Error");
             return;
         }
 
-        // Determine content type
-        std::string contentType = "text/plain";
-        std::string extension = fs::path(fullPath).extension().string();
-
-        if (extension == ".html") contentType = "text/html";
-        else if (extension == ".css") contentType = "text/css";
-        else if (extension == ".js") contentType = "application/javascript";
-        else if (extension == ".json") contentType = "application/json";
-        else if (extension == ".png") contentType = "image/png";
-        else if (extension == ".jpg" || extension == ".jpeg") contentType = "image/jpeg";
-        else if (extension == ".gif") contentType = "image/gif";
-        else if (extension == ".svg") contentType = "image/svg+xml";
-
-        // Read file content
-        std::string content = readFile(fullPath);
-        if (content.empty()) {
-            sendError(clientSocket, 500, "Internal Server Error");
+        const std::shared_ptr<const std::string>& compressed =
+            response.acceptEncoding == ContentCoding::Gzip ? page->gzip
+            : response.acceptEncoding == ContentCoding::Deflate ? page->deflate
+            : nullptr;
+        if (compressed) {
+            writeHead(response, "200 OK", asset.contentType, compressed->size())
+                .header("Content-Encoding", Compression::codingName(response.acceptEncoding))
+                .headers(vary).headers(page->validators).end();
+            response.output.append(compressed);
             return;
         }
 
-        // Apply tally fingerprint to HTML content
-        if (extension == ".html") {
-            content = fingerprintContent(content, path);
+        size_t length = page->content->size() + page->comment.size();
+        writeHead(response, "200 OK", asset.contentType, length).headers(vary).headers(page->validators).end();
+        if (page->splice == std::string::npos) {
+            response.output.append(page->content);
+            return;
         }
+        response.output.append(page->content, 0, page->splice);
+        response.output.append(page->comment);
+        response.output.append(page->content, page->splice, page->content->size() - page->splice);
+    }
+
+    // Built once: the keep-alive limits never change while the server runs
+    std::string_view connectionHeaders(const HttpResponse& response) const {
+        if (!response.keepAlive) return "Connection: close\r\n";
+        return keepAliveHeaders;
+    }
 
-        // Send HTTP response
-        sendResponse(clientSocket, "200 OK", contentType, content);
+    // Status line, Content-Type, Content-Length and Connection; the caller adds headers and end()s
+    ResponseWriter writeHead(HttpResponse& response, std::string_view status,
+                             std::string_view contentType, size_t contentLength) const {
+        ResponseWriter head = response.head();
+        head.status(status)
+            .headers("Content-Type: ").headers(contentType).headers("; charset=utf-8\r\n")
+            .header("Content-Length", (uint64_t)contentLength)
+            .headers(connectionHeaders(response));
+        return head;
     }
 
-    void sendResponse(int clientSocket, const std::string& status, const std::string& contentType, const std::string& content) {
-        std::string response = "HTTP/1.1 " + status + "\r\n"
-                             "Content-Type: " + contentType + "; charset=utf-8\r\n"
-                             "Content-Length: " + std::to_string(content.size()) + "\r\n"
-                             "Connection: close\r\n"
-                             "\r\n" + content;
+    // Small bodies are copied next to the head so both leave in one iovec; larger ones get
+    // their own buffer, since the arena they may live in is reset before the queue drains
+    static void queueBody(HttpResponse& response, std::string_view content) {
+        if (content.size() <= INLINE_BODY_BYTES) {
+            response.output.append(content);
+        } else {
+            response.output.appendOwned(std::string(content));
+        }
+    }
+
+    void sendResponse(HttpResponse& response, std::string_view status, std::string_view contentType,
+                      std::string_view content, std::string_view extraHeaders = "") {
+        // Text bodies above the threshold are deflated on the fly with this thread's zlib stream
+        if (options.compressionLevel > 0 && content.size() >= options.compressMinBytes &&
+            Compression::compressibleType(contentType)) {
+            ArenaString compressed = response.arena.string();
+            TraceSpan compressSpan("compress");
+            bool smaller = response.acceptEncoding != ContentCoding::Identity &&
+                Compression::compress(content, response.acceptEncoding, options.compressionLevel, compressed) &&
+                compressed.size() < content.size();
+            compressSpan.end();
+            if (smaller) {
+                writeHead(response, status, contentType, compressed.size())
+                    .header("Content-Encoding", Compression::codingName(response.acceptEncoding))
+                    .headers("Vary: Accept-Encoding\r\n").headers(extraHeaders).end();
+                queueBody(response, compressed);
+                return;
+            }
+            writeHead(response, status, contentType, content.size())
+                .headers("Vary: Accept-Encoding\r\n").headers(extraHeaders).end();
+            queueBody(response, content);
+            return;
+        }
+        writeHead(response, status, contentType, content.size()).headers(extraHeaders).end();
+        queueBody(response, content);
+    }
 
-        send(clientSocket, response.c_str(), response.size(), 0);
+    // 206 for the identity body of a static asset; takes ownership of fd, which is -1
+    // when the bytes are cached
+    void sendRanges(HttpResponse& response, const CachedAsset& asset, std::vector<ByteRange::Span> ranges, int fd) {
+        RangeResponse partial(std::move(ranges), asset.contentType + "; charset=utf-8", asset.size);
+        SendQueue body;
+        if (fd < 0) {
+            partial.appendBufferBody(body, asset.identity.bytes);
+        } else if (!partial.appendFileBody(body, fd)) {
+            sendError(response, 500, "Internal Server Error");
+            return;
+        }
+        response.head().status("206 Partial Content").headers(partial.headers()).headers("Accept-Ranges: bytes\r\n")
+            .headers(asset.identity.validators).headers(connectionHeaders(response)).end();
+        response.output.append(std::move(body));
     }
 
-    void sendError(int clientSocket, int code, const std::string& message) {
-        std::string response = "HTTP/1.1 " + std::to_string(code) + " " + message + "\r\n"
-                             "Content-Type: text/plain; charset=utf-8\r\n"
-                             "Connection: close\r\n"
-                             "\r\n" + message;
+    // Bodyless 304 carrying the validators (and Vary) the 200 would have sent
+    void sendNotModified(HttpResponse& response, std::string_view validators, std::string_view vary = "") {
+        response.head().status("304 Not Modified").headers(validators).headers(vary)
+            .headers(connectionHeaders(response)).end();
+    }
 
-        send(clientSocket, response.c_str(), response.size(), 0);
+    void sendError(HttpResponse& response, int code, std::string_view message,
+                   std::string_view extraHeaders = "") {
+        response.head().status(code, message)
+            .header("Content-Type", "text/plain; charset=utf-8")
+            .header("Content-Length", (uint64_t)message.size())
+            .headers(extraHeaders).headers(connectionHeaders(response)).end();
+        response.output.append(message);
     }
 };
 
@@ -1146,6 +2195,7 @@ int main(int argc, char* argv[]) {
     bool daemonMode = false;
     int port = 8080;
     std::string rootDir = ".";
+    TallyServerOptions options;
 
     // Parse command line arguments
     for (int i = 1; i < argc; i++) {
@@ -1160,11 +2210,166 @@ int main(int argc, char* argv[]) {
             if (i + 1 < argc) {
                 rootDir = argv[++i];
             }
+        } else if (arg == "--io-model") {
+            if (i + 1 < argc) {
+                options.ioModel = argv[++i];
+                if (options.ioModel != "threads" && options.ioModel != "epoll" && options.ioModel != "uring") {
+                    std::cerr << "Unknown I/O model: " << options.ioModel << " (expected threads, epoll or uring)" << std::endl;
+                    return 1;
+                }
+            }
+        } else if (arg == "--loops") {
+            if (i + 1 < argc) {
+                options.eventLoops = std::stoi(argv[++i]);
+            }
+        } else if (arg == "--workers" || arg == "-w") {
+            if (i + 1 < argc) {
+                options.workerThreads = std::stoi(argv[++i]);
+            }
+        } else if (arg == "--keepalive-timeout") {
+            if (i + 1 < argc) {
+                options.keepAliveTimeout = std::stoi(argv[++i]);
+            }
+        } else if (arg == "--keepalive-requests") {
+            if (i + 1 < argc) {
+                options.keepAliveRequests = std::stoi(argv[++i]);
+            }
+        } else if (arg == "--listeners") {
+            if (i + 1 < argc) {
+                options.listeners = std::stoi(argv[++i]);
+            }
+        } else if (arg == "--backlog") {
+            if (i + 1 < argc) {
+                options.backlog = std::stoi(argv[++i]);
+            }
+        } else if (arg == "--pin-cpus") {
+            options.pinCpus = true;
+        } else if (arg == "--cache-mb") {
+            if (i + 1 < argc) {
+                options.staticCacheMB = std::stoul(argv[++i]);
+            }
+        } else if (arg == "--warm-cache") {
+            options.warmCache = true;
+        } else if (arg == "--compression-level") {
+            if (i + 1 < argc) {
+                options.compressionLevel = std::stoi(argv[++i]);
+            }
+        } else if (arg == "--fingerprint") {
+            if (i + 1 < argc) {
+                options.fingerprintMode = argv[++i];
+                if (options.fingerprintMode != "request" && options.fingerprintMode != "version" &&
+                    options.fingerprintMode != "window") {
+                    std::cerr << "Unknown fingerprint mode: " << options.fingerprintMode
+                              << " (expected request, version or window)" << std::endl;
+                    return 1;
+                }
+            }
+        } else if (arg == "--fingerprint-window") {
+            if (i + 1 < argc) {
+                options.fingerprintWindow = std::stoi(argv[++i]);
+            }
+        } else if (arg == "--log-level") {
+            if (i + 1 < argc) {
+                if (!AsyncLogger::parseLevel(argv[++i], options.logLevel)) {
+                    std::cerr << "Unknown log level: " << argv[i] << " (expected debug, info, warn or error)" << std::endl;
+                    return 1;
+                }
+            }
+        } else if (arg == "--access-log") {
+            if (i + 1 < argc) {
+                options.accessLogFile = argv[++i];
+            }
+        } else if (arg == "--max-connections") {
+            if (i + 1 < argc) {
+                options.maxConnections = std::stoi(argv[++i]);
+            }
+        } else if (arg == "--max-queue") {
+            if (i + 1 < argc) {
+                options.maxQueued = std::stoul(argv[++i]);
+            }
+        } else if (arg == "--shed-at") {
+            if (i + 1 < argc) {
+                options.shedPercent = std::stoi(argv[++i]);
+            }
+        } else if (arg == "--retry-after") {
+            if (i + 1 < argc) {
+                options.retryAfter = std::stoi(argv[++i]);
+            }
+        } else if (arg == "--header-timeout") {
+            if (i + 1 < argc) {
+                options.headerTimeout = std::stoi(argv[++i]);
+            }
+        } else if (arg == "--body-timeout") {
+            if (i + 1 < argc) {
+                options.bodyTimeout = std::stoi(argv[++i]);
+            }
+        } else if (arg == "--write-timeout") {
+            if (i + 1 < argc) {
+                options.writeTimeout = std::stoi(argv[++i]);
+            }
+        } else if (arg == "--trace") {
+            options.trace = true;
+        } else if (arg == "--compress-min") {
+            if (i + 1 < argc) {
+                options.compressMinBytes = std::stoul(argv[++i]);
+            }
+        } else if (arg == "--tls-port") {
+            if (i + 1 < argc) {
+                options.tlsPort = std::stoi(argv[++i]);
+            }
+        } else if (arg == "--tls-cert") {
+            if (i + 1 < argc) {
+                options.tls.certFile = argv[++i];
+            }
+        } else if (arg == "--tls-key") {
+            if (i + 1 < argc) {
+                options.tls.keyFile = argv[++i];
+            }
+        } else if (arg == "--tls-session-cache") {
+            if (i + 1 < argc) {
+                options.tls.sessionCacheSize = std::stol(argv[++i]);
+            }
+        } else if (arg == "--tls-session-timeout") {
+            if (i + 1 < argc) {
+                options.tls.sessionTimeout = std::stol(argv[++i]);
+            }
+        } else if (arg == "--no-ktls") {
+            options.tls.kernelOffload = false;
         } else if (arg == "--help" || arg == "-h") {
             std::cout << "Economic Justice Tally Server Usage:" << std::endl;
             std::cout << "  --daemon, -d    Run as daemon" << std::endl;
             std::cout << "  --port, -p PORT Set server port (default: 8080)" << std::endl;
             std::cout << "  --root, -r DIR  Set root directory (default: .)" << std::endl;
+            std::cout << "  --io-model MODEL Connection handling: threads, epoll or uring (default: threads)" << std::endl;
+            std::cout << "  --loops N       Epoll / io_uring loop threads (default: one per core)" << std::endl;
+            std::cout << "  --workers, -w N Worker pool threads for the threads model (default: one per core)" << std::endl;
+            std::cout << "  --keepalive-timeout SEC  Idle timeout for persistent connections, 0 disables (default: 5)" << std::endl;
+            std::cout << "  --keepalive-requests N   Requests per persistent connection (default: 100)" << std::endl;
+            std::cout << "  --listeners N   SO_REUSEPORT listening sockets, one acceptor each (default: 1)" << std::endl;
+            std::cout << "  --backlog N     listen() backlog per socket (default: SOMAXCONN)" << std::endl;
+            std::cout << "  --pin-cpus      Pin accept threads / event loops to one core each" << std::endl;
+            std::cout << "  --cache-mb N    Static asset cache size in MB, 0 disables (default: 64)" << std::endl;
+            std::cout << "  --warm-cache    Load files under --root into the cache at startup" << std::endl;
+            std::cout << "  --compression-level N    zlib level for dynamic bodies, 0 disables gzip (default: 6)" << std::endl;
+            std::cout << "  --compress-min BYTES     Smallest dynamic body to compress (default: 1024)" << std::endl;
+            std::cout << "  --fingerprint MODE       HTML fingerprint per request, version or window (default: window)" << std::endl;
+            std::cout << "  --fingerprint-window SEC Lifetime of one fingerprint in window mode (default: 60)" << std::endl;
+            std::cout << "  --log-level LEVEL        debug, info, warn or error for tally-server.log (default: info)" << std::endl;
+            std::cout << "  --access-log FILE        Log every request with status, bytes and latency" << std::endl;
+            std::cout << "  --max-connections N      Connections admitted before new ones get 503, 0 = unlimited (default: 4096)" << std::endl;
+            std::cout << "  --max-queue N            Connections waiting for a worker before 503, 0 = unlimited (default: 1024)" << std::endl;
+            std::cout << "  --shed-at PERCENT        Load at which only /api/tally/* is served (default: 80)" << std::endl;
+            std::cout << "  --retry-after SEC        Retry-After on 503 responses (default: 1)" << std::endl;
+            std::cout << "  --header-timeout SEC     Time to send a complete request head (default: 10)" << std::endl;
+            std::cout << "  --body-timeout SEC       Stall allowed while sending a request body (default: 30)" << std::endl;
+            std::cout << "  --write-timeout SEC      Stall allowed while reading a response (default: 30)" << std::endl;
+            std::cout << "  --trace                  Record hot-path spans from startup (GET /api/server/trace)" << std::endl;
+            std::cout << "  --tls-port PORT          Also serve HTTPS on PORT (needs --tls-cert and --tls-key)" << std::endl;
+            std::cout << "  --tls-cert FILE          PEM certificate chain for HTTPS" << std::endl;
+            std::cout << "  --tls-key FILE           PEM private key for HTTPS" << std::endl;
+            std::cout << "  --tls-session-cache N    Server-side TLS sessions kept for resumption (default: 20480)" << std::endl;
+            std::cout << "  --tls-session-timeout SEC Lifetime of a resumable session or ticket (default: 7200)" << std::endl;
+            std::cout << "  --no-ktls                Keep TLS records in user space even where kernel TLS is available" << std::endl;
             std::cout << "  --help, -h      Show this help" << std::endl;
             return 0;
         }
@@ -1175,7 +2380,12 @@ int main(int argc, char* argv[]) {
         std::cout << "📖 Reimagining The King's Reckoning as secure tally network\n" << std::endl;
     }
 
-    TallyServer server(port, rootDir);
+    if (options.tlsPort > 0 && (options.tls.certFile.empty() || options.tls.keyFile.empty())) {
+        std::cerr << "--tls-port needs --tls-cert and --tls-key" << std::endl;
+        return 1;
+    }
+
+    TallyServer server(port, rootDir, options);
 
     if (!server.start(daemonMode)) {
         std::cerr << "❌ Failed to start tally server" << std::endl;
@@ -1215,8 +2425,11 @@ int main(int argc, char* argv[]) {
                 std::cout << "📈 Server Statistics:" << std::endl;
                 std::cout << "👤 User: " << server.currentUser << std::endl;
                 std::cout << "⏰ Uptime: " << server.getUptime() << std::endl;
-                std::cout << "🔌 Active Connections: " << server.activeConnections << std::endl;
-                std::cout << "👥 Active Sessions: " << server.userSessions.size() << std::endl;
+                std::cout << "🔌 Active Connections: " << server.admission.connections() << std::endl;
+                std::cout << "👥 Active Sessions: " << server.sessionCount() << std::endl;
+                std::cout << "🧵 Worker Pool: {" << server.getPoolStatsJson() << "}" << std::endl;
+                std::cout << "👂 Listeners: {" << server.getListenerStatsJson() << "}" << std::endl;
+                std::cout << "🗄️  Static Cache: " << server.getStaticCacheJson() << std::endl;
             } else if (command == "network") {
                 std::cout << "🌐 Network Information:" << std::endl;
                 std::cout << "Node ID: " << server.peerNetwork.getNodeId() << std::endl;
@@ -1250,10 +2463,10 @@ int main(int argc, char* argv[]) {
 
         std::cout << "🛑 Tally Server stopped" << std::endl;
     } else {
-        // Daemon mode - run the server directly in this thread
+        // Daemon mode - block on the server thread
         std::cout << "✅ Tally Server running in background mode on port " << port << std::endl;
         std::cout << "📝 Logs: tally-server.log" << std::endl;
-        server.run(); // Run server in foreground for daemon mode
+        serverThread.join(); // The server thread owns run(); wait for it
     }
 
     return 0;
@@ -20,7 +20,7 @@ fi
 
 # Test compilation
 echo "🔧 Testing compilation..."
-if make test-compile; then
+if make cpp-server; then
     echo "✅ Compilation test passed"
 else
     echo "❌ Compilation test failed"
@@ -46,6 +46,104 @@ else
     exit 1
 fi
 
+# Exercise /api/save against a running server: uploads stream through the JSON decoder
+# and Caesar cipher in chunks, so check the bytes on disk for bodies that span several
+# reads and chunks
+echo "💾 Testing /api/save..."
+if ! command -v python3 &> /dev/null; then
+    echo "❌ python3 is required for the /api/save tests"
+    exit 1
+fi
+
+SERVER_BIN="$(pwd)/cpp-server"
+SAVE_DIR=$(mktemp -d)
+(cd "$SAVE_DIR" && exec "$SERVER_BIN" --daemon > server.log 2>&1) &
+SERVER_PID=$!
+trap 'kill $SERVER_PID 2>/dev/null; rm -rf "$SAVE_DIR"' EXIT
+
+if ! python3 - "$SAVE_DIR" <<'EOF'
+import json, os, socket, sys, time
+
+root = sys.argv[1]
+
+def caesar(data, shift=6):
+    # The server's cipher: ASCII letters and digits rotate, every other byte is kept
+    out = bytearray()
+    for b in data:
+        if 65 <= b <= 90: b = (b - 65 + shift) % 26 + 65
+        elif 97 <= b <= 122: b = (b - 97 + shift) % 26 + 97
+        elif 48 <= b <= 57: b = (b - 48 + shift) % 10 + 48
+        out.append(b)
+    return bytes(out)
+
+def connect():
+    for _ in range(50):
+        try:
+            s = socket.create_connection(("127.0.0.1", 8000))
+            s.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+            s.settimeout(10)
+            return s
+        except OSError:
+            time.sleep(0.1)
+    raise SystemExit("server did not start on port 8000")
+
+def post(pieces, chunked=False):
+    # Each piece is a separate send with a pause, so the server reads it on its own
+    s = connect()
+    head = b"POST /api/save HTTP/1.1\r\nHost: localhost\r\nContent-Type: application/json\r\nConnection: close\r\n"
+    if chunked:
+        s.sendall(head + b"Transfer-Encoding: chunked\r\n\r\n")
+        for piece in pieces:
+            s.sendall(b"%x\r\n" % len(piece) + piece + b"\r\n")
+            time.sleep(0.05)
+        s.sendall(b"0\r\n\r\n")
+    else:
+        s.sendall(head + b"Content-Length: %d\r\n\r\n" % sum(map(len, pieces)))
+        for piece in pieces:
+            s.sendall(piece)
+            time.sleep(0.05)
+    response = b""
+    while True:
+        data = s.recv(65536)
+        if not data: break
+        response += data
+    s.close()
+    return response
+
+def check(name, pieces, expected, chunked=False):
+    response = post(pieces, chunked)
+    path = os.path.join(root, "saved", name)
+    ok = response.startswith(b"HTTP/1.1 200") and os.path.exists(path) and \
+         open(path, "rb").read() == caesar(expected)
+    print(("✅ " if ok else "❌ ") + name)
+    if not ok: print("   response: %r" % response[:200])
+    return ok
+
+def split(body, size):
+    return [body[i:i + size] for i in range(0, len(body), size)]
+
+text = "".join("line %d: Tally \"quoted\" back\\slash tab\t é 中 😀\n" % i for i in range(4000))
+body = json.dumps({"filename": "saved/large.txt", "content": text}).encode()
+results = [
+    # Several save chunks, sent as many reads
+    check("large.txt", split(body, 8191), text.encode()),
+    check("chunked.txt", split(json.dumps({"filename": "saved/chunked.txt", "content": text}).encode(), 5000),
+          text.encode(), chunked=True),
+    # The temp file is created before the filename is known
+    check("reversed.txt", [json.dumps({"content": text, "filename": "saved/reversed.txt"}).encode()], text.encode()),
+    # Escapes and a surrogate pair cut at every awkward point
+    check("escapes.txt", [b'{"filename": "saved/escapes.txt", "content": "a\\', b'nb\\u00', b'e9c\\ud8',
+                          b'3d\\', b'ude00d\\u', b'4e2d\\"\\\\', b'\\/e"}'],
+          "a\nbéc\U0001F600d中\"\\/e".encode()),
+]
+sys.exit(0 if all(results) else 1)
+EOF
+then
+    echo "❌ /api/save tests failed"
+    exit 1
+fi
+echo "✅ /api/save tests passed"
+
 echo ""
 echo "🎉 C++ ASM Server is ready!"
 echo ""
@@ -0,0 +1,153 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed-size pool where every worker owns a deque. Workers pop their own work
+// LIFO (cache-warm) and steal FIFO from a sibling when their deque runs dry.
+class WorkStealingPool {
+public:
+    using Task = std::function<void()>;
+
+    explicit WorkStealingPool(size_t threadCount = 0)
+        : pending(0), stopping(false), steals(0), executed(0), nextQueue(0) {
+        if (threadCount == 0) threadCount = defaultThreadCount();
+        for (size_t i = 0; i < threadCount; i++) {
+            workers.push_back(std::make_unique<Worker>());
+        }
+        for (size_t i = 0; i < threadCount; i++) {
+            threads.emplace_back(&WorkStealingPool::workerLoop, this, i);
+        }
+    }
+
+    ~WorkStealingPool() {
+        shutdown();
+    }
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    static size_t defaultThreadCount() {
+        unsigned cores = std::thread::hardware_concurrency();
+        return cores > 0 ? cores : 1;
+    }
+
+    // Queue a task. Workers submitting follow-up work keep it on their own deque.
+    void submit(Task task) {
+        size_t index = (currentPool == this) ? currentWorker
+                                             : nextQueue.fetch_add(1, std::memory_order_relaxed) % workers.size();
+        Worker& worker = *workers[index];
+        {
+            // Counted before it becomes visible, so a worker's fetch_sub can never run first
+            std::lock_guard<std::mutex> lock(worker.mutex);
+            pending.fetch_add(1, std::memory_order_release);
+            worker.tasks.push_back(std::move(task));
+        }
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+        }
+        wake.notify_one();
+    }
+
+    // Stop accepting wakeups, run whatever is still queued, and join the workers
+    void shutdown() {
+        if (stopping.exchange(true)) return;
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+        }
+        wake.notify_all();
+        for (auto& thread : threads) {
+            if (thread.joinable()) thread.join();
+        }
+    }
+
+    size_t size() const { return workers.size(); }
+    size_t queueDepth() const { return pending.load(std::memory_order_relaxed); }
+    uint64_t stealCount() const { return steals.load(std::memory_order_relaxed); }
+    uint64_t executedCount() const { return executed.load(std::memory_order_relaxed); }
+
+    std::vector<size_t> queueDepths() const {
+        std::vector<size_t> depths;
+        for (const auto& worker : workers) {
+            std::lock_guard<std::mutex> lock(worker->mutex);
+            depths.push_back(worker->tasks.size());
+        }
+        return depths;
+    }
+
+private:
+    struct alignas(64) Worker {
+        mutable std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::vector<std::thread> threads;
+    std::mutex sleepMutex;
+    std::condition_variable wake;
+    std::atomic<size_t> pending;
+    std::atomic<bool> stopping;
+    std::atomic<uint64_t> steals;
+    std::atomic<uint64_t> executed;
+    std::atomic<size_t> nextQueue;
+
+    static inline thread_local WorkStealingPool* currentPool = nullptr;
+    static inline thread_local size_t currentWorker = 0;
+
+    bool popLocal(size_t index, Task& task) {
+        Worker& worker = *workers[index];
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        if (worker.tasks.empty()) return false;
+        task = std::move(worker.tasks.back());
+        worker.tasks.pop_back();
+        return true;
+    }
+
+    bool steal(size_t thief, Task& task) {
+        for (size_t offset = 1; offset < workers.size(); offset++) {
+            Worker& victim = *workers[(thief + offset) % workers.size()];
+            std::unique_lock<std::mutex> lock(victim.mutex, std::try_to_lock);
+            if (!lock.owns_lock() || victim.tasks.empty()) continue;
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            steals.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+        return false;
+    }
+
+    void workerLoop(size_t index) {
+        currentPool = this;
+        currentWorker = index;
+
+        while (true) {
+            Task task;
+            if (popLocal(index, task) || steal(index, task)) {
+                pending.fetch_sub(1, std::memory_order_acq_rel);
+                task();
+                executed.fetch_add(1, std::memory_order_relaxed);
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            if (stopping && pending.load(std::memory_order_acquire) == 0) break;
+            // Steal attempts use try_lock, so re-check periodically instead of trusting one pass
+            wake.wait_for(lock, std::chrono::milliseconds(50), [this]() {
+                return stopping || pending.load(std::memory_order_acquire) > 0;
+            });
+        }
+
+        currentPool = nullptr;
+    }
+};
+
+#endif // THREAD_POOL_H
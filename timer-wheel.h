@@ -0,0 +1,164 @@
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+
+// Hierarchical timing wheel for per-connection deadlines, driven by one thread (an
+// EventLoop). Timers are intrusive, so scheduling and cancelling are O(1) list
+// operations with no allocation. Level 0 holds the next 64 ticks; each level above
+// covers 64 times the span of the one below and is cascaded down as time reaches it.
+class TimerWheel {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // Embed in the object owning the deadline; destroying it cancels the timer
+    class Timer {
+    public:
+        Timer() = default;
+        virtual ~Timer() { cancel(); }
+
+        Timer(const Timer&) = delete;
+        Timer& operator=(const Timer&) = delete;
+
+        bool armed() const { return next != nullptr; }
+
+        void cancel() {
+            if (!next) return;
+            prev->next = next;
+            next->prev = prev;
+            prev = next = nullptr;
+        }
+
+    protected:
+        // Runs on the wheel's thread once the deadline passes; the timer is already disarmed,
+        // so the owner may reschedule it or destroy itself
+        virtual void onTimeout() = 0;
+
+    private:
+        friend class TimerWheel;
+        Timer* prev = nullptr;
+        Timer* next = nullptr;
+        uint64_t expires = 0; // tick
+    };
+
+    explicit TimerWheel(std::chrono::milliseconds tick = std::chrono::milliseconds(100))
+        : tickLength(tick), start(Clock::now()), currentTick(0) {
+        for (auto& level : slots) {
+            for (Sentinel& slot : level) slot.reset();
+        }
+    }
+
+    ~TimerWheel() {
+        // Disarm everything still scheduled so owners destroyed later don't touch the slots
+        for (auto& level : slots) {
+            for (Sentinel& slot : level) {
+                while (slot.next != &slot) slot.next->cancel();
+            }
+        }
+    }
+
+    TimerWheel(const TimerWheel&) = delete;
+    TimerWheel& operator=(const TimerWheel&) = delete;
+
+    std::chrono::milliseconds tick() const { return tickLength; }
+
+    // (Re)arm `timer` to fire after `delay` from now, rounded up to whole ticks. Measured
+    // from the clock, not the last advance(), so a loop that was busy doesn't arm
+    // deadlines that are already overdue.
+    void schedule(Timer& timer, std::chrono::milliseconds delay) {
+        timer.cancel();
+        uint64_t ticks = (delay.count() + tickLength.count() - 1) / tickLength.count();
+        uint64_t nowTick = std::max(currentTick, (uint64_t)((Clock::now() - start) / tickLength));
+        timer.expires = nowTick + (ticks > 0 ? ticks : 1);
+        place(timer);
+    }
+
+    // Fire every timer whose deadline is at or before `now`; returns how many fired
+    size_t advance(Clock::time_point now = Clock::now()) {
+        uint64_t target = (uint64_t)((now - start) / tickLength);
+        size_t fired = 0;
+        while (currentTick < target) {
+            currentTick++;
+            // Level 0 wrapped: pull the next stretch of each higher level down, lowest first
+            for (int level = 1; level < LEVELS && ((currentTick >> (SLOT_BITS * (level - 1))) & SLOT_MASK) == 0; level++) {
+                cascade(slots[level][(currentTick >> (SLOT_BITS * level)) & SLOT_MASK]);
+            }
+
+            Sentinel due;
+            due.reset();
+            Sentinel& slot = slots[0][currentTick & SLOT_MASK];
+            if (slot.next == &slot) continue;
+            // Detach the slot first: callbacks may schedule into it or destroy other due timers
+            due.next = slot.next;
+            due.prev = slot.prev;
+            due.next->prev = &due;
+            due.prev->next = &due;
+            slot.reset();
+            while (due.next != &due) {
+                Timer* timer = due.next;
+                timer->cancel();
+                timer->onTimeout();
+                fired++;
+            }
+        }
+        return fired;
+    }
+
+private:
+    static constexpr int LEVELS = 4;
+    static constexpr int SLOT_BITS = 6;
+    static constexpr uint64_t SLOTS = 1 << SLOT_BITS;
+    static constexpr uint64_t SLOT_MASK = SLOTS - 1;
+
+    // List head for one slot; never fires
+    struct Sentinel : Timer {
+        void reset() {
+            Timer::next = this;
+            Timer::prev = this;
+        }
+        void onTimeout() override {}
+        ~Sentinel() override { Timer::next = nullptr; } // not a real timer: skip cancel()
+        friend class TimerWheel;
+    };
+
+    std::chrono::milliseconds tickLength;
+    Clock::time_point start;
+    uint64_t currentTick;
+    Sentinel slots[LEVELS][SLOTS];
+
+    void place(Timer& timer) {
+        uint64_t delta = timer.expires > currentTick ? timer.expires - currentTick : 0;
+        int level = 0;
+        while (level < LEVELS - 1 && delta >= (SLOTS << (SLOT_BITS * level))) level++;
+        uint64_t expires = timer.expires;
+        if (level == LEVELS - 1 && delta >= (SLOTS << (SLOT_BITS * level))) {
+            // Beyond the top level's span: park in its furthest slot and re-place on cascade
+            expires = currentTick + (SLOT_MASK << (SLOT_BITS * level));
+        }
+        Sentinel& slot = slots[level][(expires >> (SLOT_BITS * level)) & SLOT_MASK];
+        timer.prev = slot.prev;
+        timer.next = &slot;
+        slot.prev->next = &timer;
+        slot.prev = &timer;
+    }
+
+    void cascade(Sentinel& slot) {
+        Sentinel moving;
+        moving.reset();
+        if (slot.next == &slot) return;
+        moving.next = slot.next;
+        moving.prev = slot.prev;
+        moving.next->prev = &moving;
+        moving.prev->next = &moving;
+        slot.reset();
+        while (moving.next != &moving) {
+            Timer* timer = moving.next;
+            timer->cancel();
+            place(*timer);
+        }
+    }
+};
+
+#endif // TIMER_WHEEL_H
@@ -0,0 +1,282 @@
+#ifndef TLS_SESSION_H
+#define TLS_SESSION_H
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <climits>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <string>
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <openssl/bio.h>
+#include <openssl/err.h>
+#include <openssl/ssl.h>
+#include "listener.h"
+#include "send-queue.h"
+
+// Server-side TLS for accepted sockets. After the handshake OpenSSL is asked to move the
+// record layer into the kernel (kTLS). When the kernel takes the send side the socket
+// accepts plaintext, so responses keep leaving through SendQueue's writev and sendfile;
+// otherwise records are sealed here, with file ranges read in record-sized chunks.
+
+// Certificate, session resumption and counters shared by every TLS connection
+class TlsContext {
+public:
+    struct Options {
+        std::string certFile;          // PEM certificate chain
+        std::string keyFile;           // PEM private key
+        long sessionCacheSize = 20480; // server-side sessions kept for session-ID resumption
+        long sessionTimeout = 7200;    // seconds a cached session or ticket stays resumable
+        bool kernelOffload = true;     // hand the record layer to kTLS when the kernel allows it
+    };
+
+    TlsContext() = default;
+    ~TlsContext() {
+        if (ctx) SSL_CTX_free(ctx);
+    }
+
+    TlsContext(const TlsContext&) = delete;
+    TlsContext& operator=(const TlsContext&) = delete;
+
+    // False, with the reason in `error`, when the certificate or key cannot be used
+    bool init(const Options& options, std::string& error) {
+        ctx = SSL_CTX_new(TLS_server_method());
+        if (!ctx) return fail("cannot create TLS context", error);
+        SSL_CTX_set_min_proto_version(ctx, TLS1_2_VERSION);
+        if (SSL_CTX_use_certificate_chain_file(ctx, options.certFile.c_str()) != 1) {
+            return fail("cannot load certificate " + options.certFile, error);
+        }
+        if (SSL_CTX_use_PrivateKey_file(ctx, options.keyFile.c_str(), SSL_FILETYPE_PEM) != 1) {
+            return fail("cannot load private key " + options.keyFile, error);
+        }
+        if (SSL_CTX_check_private_key(ctx) != 1) return fail("private key does not match the certificate", error);
+
+        // A peer closing without close_notify reads as a plain EOF: HTTP framing already
+        // tells a complete message from a truncated one
+        uint64_t flags = SSL_OP_NO_COMPRESSION | SSL_OP_CIPHER_SERVER_PREFERENCE | SSL_OP_IGNORE_UNEXPECTED_EOF;
+        if (options.kernelOffload) flags |= SSL_OP_ENABLE_KTLS;
+        SSL_CTX_set_options(ctx, flags);
+        // Idle keep-alive connections give their record buffers back
+        SSL_CTX_set_mode(ctx, SSL_MODE_RELEASE_BUFFERS);
+
+        // Resumption skips the key exchange and certificate signature: stateless tickets
+        // (sealed with a key generated at startup) for clients that take them, and a
+        // server-side cache for TLS 1.2 clients that only offer a session ID
+        static const unsigned char sessionContext[] = "tally-server";
+        SSL_CTX_set_session_id_context(ctx, sessionContext, sizeof(sessionContext) - 1);
+        SSL_CTX_set_session_cache_mode(ctx, SSL_SESS_CACHE_SERVER);
+        SSL_CTX_sess_set_cache_size(ctx, options.sessionCacheSize);
+        SSL_CTX_set_timeout(ctx, options.sessionTimeout);
+        return true;
+    }
+
+    SSL_CTX* handle() const { return ctx; }
+
+    uint64_t fullHandshakes() const { return full.load(std::memory_order_relaxed); }
+    uint64_t resumedHandshakes() const { return resumed.load(std::memory_order_relaxed); }
+    uint64_t failedHandshakes() const { return failed.load(std::memory_order_relaxed); }
+    uint64_t kernelSendSessions() const { return kernelSend.load(std::memory_order_relaxed); }
+    uint64_t kernelRecvSessions() const { return kernelRecv.load(std::memory_order_relaxed); }
+
+    // Completed handshakes during the last complete second
+    uint64_t handshakesLastSecond() const { return completed.lastSecond(); }
+
+    // Resumed over completed handshakes since startup
+    double resumptionRatio() const {
+        uint64_t done = fullHandshakes() + resumedHandshakes();
+        return done ? (double)resumedHandshakes() / done : 0.0;
+    }
+
+    std::string toJson() const {
+        char buffer[320];
+        snprintf(buffer, sizeof(buffer),
+                 "{\"handshakes\":%llu,\"resumed\":%llu,\"failed\":%llu,\"handshakes_per_sec\":%llu,"
+                 "\"resumption_ratio\":%.3f,\"ktls_send\":%llu,\"ktls_recv\":%llu,\"cached_sessions\":%ld}",
+                 (unsigned long long)(fullHandshakes() + resumedHandshakes()), (unsigned long long)resumedHandshakes(),
+                 (unsigned long long)failedHandshakes(), (unsigned long long)handshakesLastSecond(),
+                 resumptionRatio(), (unsigned long long)kernelSendSessions(),
+                 (unsigned long long)kernelRecvSessions(), SSL_CTX_sess_number(ctx));
+        return buffer;
+    }
+
+private:
+    friend class TlsSession;
+
+    SSL_CTX* ctx = nullptr;
+    std::atomic<uint64_t> full{0};
+    std::atomic<uint64_t> resumed{0};
+    std::atomic<uint64_t> failed{0};
+    std::atomic<uint64_t> kernelSend{0};
+    std::atomic<uint64_t> kernelRecv{0};
+    AcceptStats completed;
+
+    bool fail(const std::string& message, std::string& error) {
+        unsigned long code = ERR_get_error();
+        error = message;
+        if (code) {
+            char reason[256];
+            ERR_error_string_n(code, reason, sizeof(reason));
+            error += ": " + std::string(reason);
+        }
+        ERR_clear_error();
+        return false;
+    }
+};
+
+// One TLS connection over a socket the caller owns. Works on blocking and non-blocking
+// sockets alike: a call that cannot finish reports WantRead/WantWrite (EAGAIN), which on a
+// blocking socket means its SO_RCVTIMEO/SO_SNDTIMEO expired.
+class TlsSession {
+public:
+    enum class Status { Done, WantRead, WantWrite, Error };
+
+    static constexpr size_t RECORD_SIZE = 16384; // largest TLS record payload
+
+    TlsSession(TlsContext& context, int fd) : context(context), socket(fd), ssl(SSL_new(context.handle())) {
+        if (!ssl) return;
+        SSL_set_fd(ssl, fd);
+        SSL_set_accept_state(ssl);
+        // Handshake flights and records go out as several writes that are each complete,
+        // so Nagle would only hold the last one back for the client's delayed ACK
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    }
+
+    // Connections that never finished the handshake count as failed
+    ~TlsSession() {
+        if (!established) context.failed.fetch_add(1, std::memory_order_relaxed);
+        if (ssl) SSL_free(ssl);
+    }
+
+    TlsSession(const TlsSession&) = delete;
+    TlsSession& operator=(const TlsSession&) = delete;
+
+    bool isEstablished() const { return established; }
+    bool kernelSend() const { return offloadedSend; }
+
+    // Advance the handshake; Done once application data can flow
+    Status handshake() {
+        if (!ssl) return Status::Error;
+        ERR_clear_error();
+        int result = SSL_do_handshake(ssl);
+        if (result != 1) return classify(SSL_get_error(ssl, result));
+
+        established = true;
+        offloadedSend = BIO_get_ktls_send(SSL_get_wbio(ssl)) > 0;
+        bool offloadedRecv = BIO_get_ktls_recv(SSL_get_rbio(ssl)) > 0;
+        (SSL_session_reused(ssl) ? context.resumed : context.full).fetch_add(1, std::memory_order_relaxed);
+        if (offloadedSend) context.kernelSend.fetch_add(1, std::memory_order_relaxed);
+        if (offloadedRecv) context.kernelRecv.fetch_add(1, std::memory_order_relaxed);
+        context.completed.record();
+        return Status::Done;
+    }
+
+    // Like recv(2): bytes decrypted into `buffer`, 0 once the peer closed, -1 with errno
+    // EAGAIN while no complete record has arrived
+    ssize_t read(char* buffer, size_t length) {
+        ERR_clear_error();
+        int n = SSL_read(ssl, buffer, (int)std::min(length, (size_t)INT_MAX));
+        if (n > 0) return n;
+        int error = SSL_get_error(ssl, n);
+        if (error == SSL_ERROR_ZERO_RETURN) return 0;
+        Status result = classify(error);
+        if (result == Status::WantRead || result == Status::WantWrite) errno = EAGAIN;
+        return -1;
+    }
+
+    // Like SendQueue::writeTo(). With kTLS on the send side the queue goes straight to the
+    // socket; otherwise it is sealed one record at a time. A record is copied out of the
+    // queue but only consumed once SSL_write takes it, so a write that would block is
+    // retried with the same bytes.
+    SendQueue::Result write(SendQueue& queue) {
+        if (offloadedSend) return queue.writeTo(socket);
+        while (true) {
+            if (staged.empty()) {
+                if (queue.empty()) return SendQueue::Result::Done;
+                if (!stage(queue)) return SendQueue::Result::Error;
+            }
+            ERR_clear_error();
+            int n = SSL_write(ssl, staged.data(), (int)staged.size());
+            if (n <= 0) {
+                Status result = classify(SSL_get_error(ssl, n));
+                if (result == Status::WantRead || result == Status::WantWrite) return SendQueue::Result::WouldBlock;
+                return SendQueue::Result::Error;
+            }
+            if (stagedFile) queue.consumeFile(staged.size());
+            else queue.consume(staged.size());
+            staged.clear();
+        }
+    }
+
+    // Best-effort close_notify before the caller closes the socket; never waits for it
+    void shutdown() {
+        if (!established || broken) return;
+        int flags = fcntl(socket, F_GETFL);
+        if (flags >= 0 && !(flags & O_NONBLOCK)) fcntl(socket, F_SETFL, flags | O_NONBLOCK);
+        ERR_clear_error();
+        SSL_shutdown(ssl);
+    }
+
+private:
+    TlsContext& context;
+    int socket;
+    SSL* ssl;
+    bool established = false;
+    bool offloadedSend = false;
+    bool broken = false; // a fatal error: no further calls, not even close_notify
+    std::string staged;  // the record being written
+    bool stagedFile = false;
+
+    // Map an SSL_get_error() code; anything but "try again" leaves the session unusable
+    Status classify(int error) {
+        if (error == SSL_ERROR_WANT_READ) return Status::WantRead;
+        if (error == SSL_ERROR_WANT_WRITE) return Status::WantWrite;
+        int saved = errno;
+        broken = true;
+        ERR_clear_error();
+        errno = error == SSL_ERROR_SYSCALL && saved ? saved : EIO;
+        return Status::Error;
+    }
+
+    // Copy the next record's worth of the queue into `staged`: the front file range read
+    // from disk, or the leading byte runs
+    bool stage(const SendQueue& queue) {
+        int file = -1;
+        off_t offset = 0;
+        size_t remaining = 0;
+        stagedFile = queue.frontFile(&file, &offset, &remaining);
+        staged.resize(RECORD_SIZE);
+        if (stagedFile) {
+            ssize_t n;
+            do {
+                n = pread(file, &staged[0], std::min(remaining, RECORD_SIZE), offset);
+            } while (n < 0 && errno == EINTR);
+            if (n <= 0) { // the file shrank under us, the body would be short
+                staged.clear();
+                return false;
+            }
+            staged.resize(n);
+            return true;
+        }
+
+        iovec iov[SendQueue::MAX_IOV];
+        size_t count = queue.gather(iov, SendQueue::MAX_IOV);
+        size_t used = 0;
+        for (size_t i = 0; i < count && used < RECORD_SIZE; i++) {
+            size_t take = std::min(iov[i].iov_len, RECORD_SIZE - used);
+            memcpy(&staged[used], iov[i].iov_base, take);
+            used += take;
+        }
+        staged.resize(used);
+        return true;
+    }
+};
+
+#endif // TLS_SESSION_H
@@ -0,0 +1,144 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
+#include <memory>
+#include <mutex>
+#include <pthread.h>
+#include <string>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <vector>
+
+// Span tracing for the request path, exported in the Chrome trace event format
+// (chrome://tracing, ui.perfetto.dev). Each thread records finished spans into its own
+// fixed ring, overwriting the oldest, so recording never locks or allocates after the
+// ring exists. While tracing is off a span costs one relaxed load.
+class Tracer {
+public:
+    static constexpr size_t EVENTS_PER_THREAD = 16384; // power of two
+
+    static Tracer& instance() {
+        static Tracer tracer;
+        return tracer;
+    }
+
+    void enable(bool on) { active.store(on, std::memory_order_relaxed); }
+    bool enabled() const { return active.load(std::memory_order_relaxed); }
+
+    // Nanoseconds on a clock NTP never slews, read through the vDSO
+    static uint64_t now() {
+        timespec ts;
+        clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+        return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+    }
+
+    // `name` must outlive the tracer, in practice a string literal
+    void record(const char* name, uint64_t start, uint64_t end) {
+        Ring& ring = threadRing();
+        uint64_t position = ring.head.load(std::memory_order_relaxed);
+        Event& event = ring.events[position & (EVENTS_PER_THREAD - 1)];
+        event.name.store(name, std::memory_order_relaxed);
+        event.start.store(start, std::memory_order_relaxed);
+        event.duration.store(end - start, std::memory_order_relaxed);
+        ring.head.store(position + 1, std::memory_order_release);
+    }
+
+    // Spans that started within the last `seconds`, as a Chrome trace JSON document
+    std::string toChromeJson(double seconds) const {
+        uint64_t cutoff = now() - std::min<uint64_t>(now(), (uint64_t)(seconds * 1e9));
+        int pid = getpid();
+        std::string out = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+        bool first = true;
+        char line[256];
+
+        std::lock_guard<std::mutex> lock(ringsMutex);
+        for (const auto& ring : rings) {
+            snprintf(line, sizeof(line),
+                     "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,\"args\":{\"name\":\"%s\"}}",
+                     first ? "" : ",", pid, ring->tid, ring->threadName);
+            out += line;
+            first = false;
+
+            uint64_t head = ring->head.load(std::memory_order_acquire);
+            uint64_t oldest = head > EVENTS_PER_THREAD ? head - EVENTS_PER_THREAD : 0;
+            for (uint64_t position = oldest; position < head; position++) {
+                const Event& event = ring->events[position & (EVENTS_PER_THREAD - 1)];
+                const char* name = event.name.load(std::memory_order_relaxed);
+                uint64_t start = event.start.load(std::memory_order_relaxed);
+                uint64_t duration = event.duration.load(std::memory_order_relaxed);
+                // The owner keeps writing while we read: drop slots it may have reused meanwhile
+                uint64_t latest = ring->head.load(std::memory_order_acquire);
+                if (latest > EVENTS_PER_THREAD && position < latest - EVENTS_PER_THREAD) continue;
+                if (start < cutoff) continue;
+                snprintf(line, sizeof(line),
+                         ",{\"name\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":%d,\"tid\":%d}",
+                         name, start / 1e3, duration / 1e3, pid, ring->tid);
+                out += line;
+            }
+        }
+        out += "]}";
+        return out;
+    }
+
+private:
+    struct Event {
+        std::atomic<const char*> name{nullptr};
+        std::atomic<uint64_t> start{0};
+        std::atomic<uint64_t> duration{0};
+    };
+
+    // Written only by its thread; kept after the thread exits so its spans can still be dumped
+    struct Ring {
+        int tid = 0;
+        char threadName[16] = "";
+        std::atomic<uint64_t> head{0};
+        std::unique_ptr<Event[]> events{new Event[EVENTS_PER_THREAD]};
+    };
+
+    std::atomic<bool> active{false};
+    mutable std::mutex ringsMutex;
+    std::vector<std::unique_ptr<Ring>> rings;
+
+    Tracer() = default;
+
+    Ring& threadRing() {
+        thread_local Ring* ring = nullptr;
+        if (!ring) {
+            auto created = std::make_unique<Ring>();
+            created->tid = (int)syscall(SYS_gettid);
+            pthread_getname_np(pthread_self(), created->threadName, sizeof(created->threadName));
+            ring = created.get();
+            std::lock_guard<std::mutex> lock(ringsMutex);
+            rings.push_back(std::move(created));
+        }
+        return *ring;
+    }
+};
+
+// Records the time from construction to end() or destruction as one span
+class TraceSpan {
+public:
+    explicit TraceSpan(const char* name)
+        : name(Tracer::instance().enabled() ? name : nullptr), start(this->name ? Tracer::now() : 0) {}
+    ~TraceSpan() { end(); }
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+    void end() {
+        if (!name) return;
+        Tracer::instance().record(name, start, Tracer::now());
+        name = nullptr;
+    }
+
+private:
+    const char* name;
+    uint64_t start;
+};
+
+#endif // TRACE_H